@@ -2,13 +2,17 @@
  ** Name: c_dynamic_arrays_macros.h
  ** Purpose:  Provides dynamic arrays as macros.
  ** Author: (JE) Jens Elstner
- ** Version: v0.1.3
+ ** Version: v0.2.3
  *******************************************************************************
  ** Date        User  Log
  **-----------------------------------------------------------------------------
  ** 11.04.2021  JE    Created lib.
  ** 19.04.2021  JE    Renamed 'ptArray' to 'tArray'.
  ** 17.07.2023  JE    Deleted if (ptr != NULL) in front of each free(ptr).
+ ** 19.10.2026  JE    Added binary heap macros 's_heap()', 'hp*()' and the
+ **                   k-way merge helper 'hpMerge()' on top of 't_array'.
+ ** 19.10.2026  JE    Added 'daReset()' to reuse an array without reallocation.
+ ** 19.10.2026  JE    'hpMerge()' checks its index memory and reports in 'fOk'.
  *******************************************************************************/
 
 
@@ -93,6 +97,54 @@
 //*   }
 //*
 //******************************************************************************
+//* Binary heap (priority queue):
+//*-------------------------------
+//* A heap keeps its values in a 't_array' of the same type, so 's_array(type)'
+//* has to be declared prior 's_heap(type)'. The comparator is 'qsort()'
+//* compatible and the value comparing smallest is always on top (min-heap).
+//*
+//*   s_array(size_t);
+//*   s_heap(size_t);
+//*
+//*   int cmpSizeT(const void* pA, const void* pB) {
+//*     size_t a = *(const size_t*) pA, b = *(const size_t*) pB;
+//*     return (a > b) - (a < b);
+//*   }
+//*
+//*   t_heap(size_t) myHp;
+//*   size_t         sVal = 0;
+//*
+//*   hpInit(size_t, myHp, cmpSizeT);
+//*
+//*   hpPush(size_t, myHp, 100);
+//*   hpPush(size_t, myHp, 1);
+//*   hpPush(size_t, myHp, 10);
+//*
+//*   sVal = hpTop(myHp);               // 1
+//*
+//*   while (hpCount(myHp) > 0) {
+//*     hpPop(size_t, myHp, sVal);      // 1, 10, 100
+//*     ...
+//*   }
+//*
+//*   hpFree(myHp);
+//*
+//* Values added directly with 'daAdd(type, myHp.tArr, value)' need a
+//* 'hpHeapify(type, myHp)' afterwards to restore the heap order in O(n).
+//*
+//* Sorted runs (i.e. results of parallel workers) are merged into one sorted
+//* array with 'hpMerge()'. On equal values the run with lower index comes
+//* first, so the merge is stable. 'fOk' is 0, if there was no memory for the
+//* run indices, then 'myDa' is left unchanged.
+//*
+//*   t_array(size_t) aRuns[4];
+//*   t_array(size_t) myDa;
+//*   int             fOk;
+//*
+//*   daInit(size_t, myDa);
+//*   hpMerge(size_t, aRuns, 4, myDa, cmpSizeT, fOk);
+//*
+//******************************************************************************
 
 
 
@@ -107,6 +159,13 @@
 
 #define t_array(type) struct _s_array_ ## type
 
+#define s_heap(type) struct _s_heap_ ## type { \
+  t_array(type) tArr; \
+  int (*fCmp)(const void*, const void*); \
+}
+
+#define t_heap(type) struct _s_heap_ ## type
+
 
 //******************************************************************************
 //* int
@@ -150,6 +209,14 @@
   daInit(type, tArray); \
 }
 
+/*******************************************************************************
+ * Name:  daReset
+ * Purpose: Reset dynamic array, but keep its memory for reuse.
+ *******************************************************************************/
+#define daReset(tArray) { \
+  tArray.sCount = 0; \
+}
+
 /*******************************************************************************
  * Name:  daFreeEx
  * Purpose: Free memory of dynamic array.
@@ -169,4 +236,162 @@
 }
 
 
+
+//******************************************************************************
+//* heap
+
+/*******************************************************************************
+ * Name:  hpSiftUp
+ * Purpose: Internal. Moves value at index up until heap order is restored.
+ *******************************************************************************/
+#define hpSiftUp(type, tHeap, sIndex) { \
+  size_t hpChild  = sIndex; \
+  size_t hpParent = 0; \
+  type   hpTmp; \
+  while (hpChild > 0) { \
+    hpParent = (hpChild - 1) / 2; \
+    if (tHeap.fCmp(&tHeap.tArr.pVal[hpChild], &tHeap.tArr.pVal[hpParent]) >= 0) break; \
+    hpTmp                      = tHeap.tArr.pVal[hpChild]; \
+    tHeap.tArr.pVal[hpChild]   = tHeap.tArr.pVal[hpParent]; \
+    tHeap.tArr.pVal[hpParent]  = hpTmp; \
+    hpChild                    = hpParent; \
+  } \
+}
+
+/*******************************************************************************
+ * Name:  hpSiftDown
+ * Purpose: Internal. Moves value at index down until heap order is restored.
+ *******************************************************************************/
+#define hpSiftDown(type, tHeap, sIndex) { \
+  size_t hpParent = sIndex; \
+  size_t hpChild  = 0; \
+  type   hpTmp; \
+  while ((hpChild = 2 * hpParent + 1) < tHeap.tArr.sCount) { \
+    if (hpChild + 1 < tHeap.tArr.sCount && \
+        tHeap.fCmp(&tHeap.tArr.pVal[hpChild + 1], &tHeap.tArr.pVal[hpChild]) < 0) \
+      ++hpChild; \
+    if (tHeap.fCmp(&tHeap.tArr.pVal[hpChild], &tHeap.tArr.pVal[hpParent]) >= 0) break; \
+    hpTmp                      = tHeap.tArr.pVal[hpChild]; \
+    tHeap.tArr.pVal[hpChild]   = tHeap.tArr.pVal[hpParent]; \
+    tHeap.tArr.pVal[hpParent]  = hpTmp; \
+    hpParent                   = hpChild; \
+  } \
+}
+
+/*******************************************************************************
+ * Name:  hpInit
+ * Purpose: Initialze heap of type with a qsort() like comparator.
+ *******************************************************************************/
+#define hpInit(type, tHeap, fCompare) { \
+  daInit(type, tHeap.tArr); \
+  tHeap.fCmp = fCompare; \
+}
+
+/*******************************************************************************
+ * Name:  hpCount
+ * Purpose: Number of values in heap.
+ *******************************************************************************/
+#define hpCount(tHeap) (tHeap.tArr.sCount)
+
+/*******************************************************************************
+ * Name:  hpTop
+ * Purpose: Smallest value of heap. Heap must not be empty.
+ *******************************************************************************/
+#define hpTop(tHeap) (tHeap.tArr.pVal[0])
+
+/*******************************************************************************
+ * Name:  hpPush
+ * Purpose: Adds a value to a heap.
+ *******************************************************************************/
+#define hpPush(type, tHeap, value) { \
+  daAdd(type, tHeap.tArr, value); \
+  hpSiftUp(type, tHeap, tHeap.tArr.sCount - 1); \
+}
+
+/*******************************************************************************
+ * Name:  hpPop
+ * Purpose: Removes smallest value from heap and stores it in var.
+ *******************************************************************************/
+#define hpPop(type, tHeap, var) { \
+  var                = tHeap.tArr.pVal[0]; \
+  tHeap.tArr.pVal[0] = tHeap.tArr.pVal[--tHeap.tArr.sCount]; \
+  hpSiftDown(type, tHeap, 0); \
+}
+
+/*******************************************************************************
+ * Name:  hpHeapify
+ * Purpose: Restores heap order of all values in O(n).
+ *******************************************************************************/
+#define hpHeapify(type, tHeap) { \
+  for (size_t hpI = tHeap.tArr.sCount / 2; hpI-- > 0;) \
+    hpSiftDown(type, tHeap, hpI); \
+}
+
+/*******************************************************************************
+ * Name:  hpFree
+ * Purpose: Free memory of heap.
+ *******************************************************************************/
+#define hpFree(tHeap) { \
+  daFree(tHeap.tArr); \
+}
+
+/*******************************************************************************
+ * Name:  hpClear
+ * Purpose: Reset heap, but keep its comparator.
+ *******************************************************************************/
+#define hpClear(type, tHeap) { \
+  daClear(type, tHeap.tArr); \
+}
+
+/*******************************************************************************
+ * Name:  hpRunSiftDown
+ * Purpose: Internal. Sift down for 'hpMerge()'s heap of run indices. Ties are
+ *          resolved by run index to keep the merge stable.
+ *******************************************************************************/
+#define hpRunSiftDown(atRuns, hpRun, hpPos, hpCnt, sIndex, fCompare) { \
+  size_t hpPar = sIndex; \
+  size_t hpChd = 0; \
+  size_t hpSwp = 0; \
+  int    hpCmp = 0; \
+  while ((hpChd = 2 * hpPar + 1) < hpCnt) { \
+    if (hpChd + 1 < hpCnt) { \
+      hpCmp = fCompare(&atRuns[hpRun[hpChd + 1]].pVal[hpPos[hpRun[hpChd + 1]]], \
+                       &atRuns[hpRun[hpChd]].pVal[hpPos[hpRun[hpChd]]]); \
+      if (hpCmp < 0 || (hpCmp == 0 && hpRun[hpChd + 1] < hpRun[hpChd])) ++hpChd; \
+    } \
+    hpCmp = fCompare(&atRuns[hpRun[hpChd]].pVal[hpPos[hpRun[hpChd]]], \
+                     &atRuns[hpRun[hpPar]].pVal[hpPos[hpRun[hpPar]]]); \
+    if (hpCmp > 0 || (hpCmp == 0 && hpRun[hpChd] > hpRun[hpPar])) break; \
+    hpSwp = hpRun[hpChd]; hpRun[hpChd] = hpRun[hpPar]; hpRun[hpPar] = hpSwp; \
+    hpPar = hpChd; \
+  } \
+}
+
+/*******************************************************************************
+ * Name:  hpMerge
+ * Purpose: Merges sRuns sorted dynamic arrays into tOut (k-way merge). Uses a
+ *          heap of run indices ordered by each run's current value. Sets fOk
+ *          to 0 and leaves tOut unchanged, if the indices get no memory.
+ *******************************************************************************/
+#define hpMerge(type, atRuns, sRuns, tOut, fCompare, fOk) { \
+  size_t* hpRun = (size_t*) malloc(sizeof(size_t) * ((sRuns) + 1)); \
+  size_t* hpPos = (size_t*) calloc((sRuns) + 1, sizeof(size_t)); \
+  size_t  hpCnt = 0; \
+  fOk = (hpRun != NULL && hpPos != NULL); \
+  /* Fill index heap with all non empty runs and put them in order. */ \
+  for (size_t hpR = 0; fOk && hpR < (sRuns); ++hpR) \
+    if (atRuns[hpR].sCount > 0) hpRun[hpCnt++] = hpR; \
+  for (size_t hpI = hpCnt / 2; hpI-- > 0;) \
+    hpRunSiftDown(atRuns, hpRun, hpPos, hpCnt, hpI, fCompare); \
+  /* Take smallest head, advance its run and sift it down again. */ \
+  while (hpCnt > 0) { \
+    daAdd(type, tOut, atRuns[hpRun[0]].pVal[hpPos[hpRun[0]]]); \
+    if (++hpPos[hpRun[0]] >= atRuns[hpRun[0]].sCount) hpRun[0] = hpRun[--hpCnt]; \
+    hpRunSiftDown(atRuns, hpRun, hpPos, hpCnt, 0, fCompare); \
+  } \
+  free(hpRun); \
+  free(hpPos); \
+}
+
+
 #endif // C_DYNAMIC_ARRAYS_MACROS_H
@@ -2,7 +2,7 @@
  ** Name: c_my_regex.h
  ** Purpose:  Provides an easy interface for pcre.h.
  ** Author: (JE) Jens Elstner
- ** Version: v0.11.2
+ ** Version: v0.28.8
  *******************************************************************************
  ** Date        User  Log
  **-----------------------------------------------------------------------------
@@ -30,6 +30,67 @@
  ** 20.12.2023  JE    Now in 'rxMatch()' and 'rxInitMatcher()' 'pcsErr' and
  **                   'piErr' can be NULL.
  ** 24.01.2024  JE    Added a 'HowTo use' comment.
+ ** 19.10.2026  JE    Now patterns are JIT compiled by default, flag 'J' turns
+ **                   it off. Each matcher owns a JIT stack and match context.
+ ** 19.10.2026  JE    Fixed: Compile options are no longer passed to
+ **                   'pcre2_match()' as match options.
+ ** 19.10.2026  JE    Now pMatchData is created once in 'rxInitMatcher()'.
+ ** 19.10.2026  JE    Added flag 'o' (offsets only) and 'rxGetMatch()' to get
+ **                   submatch strings on request. 'rxMatch()' now reuses all
+ **                   array and string memory.
+ ** 19.10.2026  JE    Now 'rxMatch()' keeps the subject's length within a
+ **                   RX_KEEP_POS loop, instead of calling strlen() each time.
+ ** 19.10.2026  JE    Added 'rxForEach()' calling back on each match without
+ **                   any allocation and 'rx_exec()' for JIT or interpreter.
+ ** 19.10.2026  JE    Added literal prefix prefilter. 'rxInitMatcher()' takes
+ **                   the first code unit, 'rxSetPrefix()' sets a longer one.
+ ** 19.10.2026  JE    Added 't_rx_set' with 'rxInitSet()', 'rxSetForEach()',
+ **                   'rxFreeSet()' scanning for many patterns in one pass.
+ ** 19.10.2026  JE    Added 't_rx_stream' with 'rxInitStream()',
+ **                   'rxStreamSpace()', 'rxStreamFeed()' and 'rxFreeStream()'
+ **                   for matching across chunks using PCRE2_PARTIAL_HARD.
+ ** 19.10.2026  JE    Split off read-only 't_rx_pattern' from 't_rx_matcher',
+ **                   which now holds only match state. 'rxInitPattern()'
+ **                   compiles once, 'rxInitMatcherShared()' creates a state
+ **                   per thread for it. JIT partial code is made upfront.
+ ** 19.10.2026  JE    Added 'rxParallelScan()' scanning a buffer's ranges in
+ **                   worker threads and merging their hits in offset order.
+ ** 19.10.2026  JE    Added 'rxInitPatternCached()' and 'rxInitMatcherCached()'
+ **                   loading compiled patterns from an on-disk cache.
+ ** 19.10.2026  JE    Added flags 'D' and 'S' for DFA matching with a reused
+ **                   workspace, reporting the longest or shortest match.
+ ** 19.10.2026  JE    Added optional profiling counters 't_rx_stats' with
+ **                   'rxEnableStats()', 'rxGetStats()' and 'rxPrintStats()'.
+ ** 19.10.2026  JE    Added 'rxSetLimits()' for match, depth and heap limits and
+ **                   error code RX_LIMIT. Scanners skip a candidate hitting a
+ **                   limit and go on. Each matcher has a counting allocator.
+ ** 19.10.2026  JE    Added 'rxReplace()' and 'rxReplaceAll()' using
+ **                   pcre2_substitute() into a reused cstr.
+ ** 19.10.2026  JE    Added 'rxSplit()' filling a reused array of field spans.
+ ** 19.10.2026  JE    Added flag 'u' for UTF-8 and Unicode properties. A subject
+ **                   is validated once, then PCRE2_NO_UTF_CHECK is passed.
+ ** 19.10.2026  JE    Added 'rxGroupIndex()' and 'rxPatternGroupIndex()' using a
+ **                   hash table of the pattern's named groups.
+ ** 19.10.2026  JE    Added 'rxAddStats()' to sum up counters of matchers used
+ **                   by several threads.
+ ** 19.10.2026  JE    Fixed: 'rxParallelScan()' lost matches behind a skipped
+ **                   hit, if no worker's hit followed. Now it matches serially
+ **                   until it meets one again.
+ ** 19.10.2026  JE    Fixed: 'rx_cache_load()' checks lengths against the file
+ **                   size, allocations, a hash of the bytes and the number of
+ **                   patterns before decoding. Cache files are now 'RXC2'.
+ ** 19.10.2026  JE    Fixed: 'rxInitSet()' rejects flag 'x'. Documented, that a
+ **                   set's scan doesn't report matches overlapping another.
+ ** 19.10.2026  JE    Now uses 'csReserve()' and 'csSetMem()' of c_string.h
+ **                   v0.25.0, so submatches keep '\0' bytes. A failed
+ **                   'rxMatch()' resets the match count.
+ ** 19.10.2026  JE    Now PCRE2_USE_OFFSET_LIMIT is only set for patterns with
+ **                   a prefix of two bytes and more. 'rxSetPatternPrefix()'
+ **                   compiles them again with 'rx_compile()'.
+ ** 19.10.2026  JE    Now 'sRightCtx' of a stream counts behind a match's end.
+ ** 19.10.2026  JE    Now 'rxSetPatternPrefix()' and 'rxSetPrefix()' take a
+ **                   pcsErr for the error of compiling once more.
+ ** 19.10.2026  JE    'rxParallelScan()' fails, if 'hpMerge()' gets no memory.
  *******************************************************************************/
 
 
@@ -49,6 +110,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include "c_string.h"
 #include "c_dynamic_arrays_macros.h"
@@ -64,10 +130,37 @@
 #define RX_NO_MATCH  0x01
 #define RX_NO_VECTOR 0x02
 #define RX_ERROR     0x03
+#define RX_LIMIT     0x04
+
+// pcre2 return values of exceeded match, depth or heap limits.
+#define RX_IS_LIMIT(iRv) ((iRv) == PCRE2_ERROR_MATCHLIMIT || \
+                          (iRv) == PCRE2_ERROR_DEPTHLIMIT || \
+                          (iRv) == PCRE2_ERROR_HEAPLIMIT)
+
+// Header of each block of the matcher's allocator, keeps 16 byte alignment.
+#define RX_MEM_HEADER 16
 
 #define RX_KEEP_POS (~0L) // Get -1 or largest number.
 #define RX_LEN_MAX  (~0L) // Get -1 or largest number.
 
+// Max length of a literal prefix for the prefilter.
+#define RX_PREFIX_MAX 32
+
+// JIT stack per matcher, grows on demand from start to max size.
+#define RX_JIT_STACK_START (32 * 1024)
+#define RX_JIT_STACK_MAX   (1024 * 1024)
+
+// DFA workspace per matcher in ints, doubled on demand.
+#define RX_DFA_WORKSPACE 1024
+
+// Magic of a cached compiled pattern file and its biggest accepted size.
+#define RX_CACHE_MAGIC    "RXC2"
+#define RX_CACHE_SIZE_MAX (16 * 1024 * 1024)
+
+// rxParallelScan() cuts about four ranges per thread, but none below this.
+#define RX_PAR_RANGES_PER_THREAD 4
+#define RX_PAR_RANGE_MIN         (64 * 1024)
+
 #define O_START(var) (2 * var)      // Even index.
 #define O_END(var)   (2 * var + 1)  // Odd index.
 
@@ -92,6 +185,29 @@
 //*   rv = rxInitMatcher(&prxMatcher, crxCoord, "x", NULL);
 //*   ...
 //*
+//* Flags are 'x', 'i', 'm', 's' like in Perl. Patterns are JIT compiled, if
+//* the PCRE2 lib supports it, else the interpreter is used silently. Flag 'J'
+//* forces the interpreter. 'rxMatcher.prxPattern->fJit' tells, which one is
+//* used.
+//*
+//* Flag 'D' uses the DFA algorithm (pcre2_dfa_match()) instead. It doesn't
+//* backtrack, so its time is predictable even for nested quantifiers, but it
+//* knows no submatches, back references or (*MARK). Only the whole match is
+//* reported, the longest one at a start offset or, with 'S', the shortest.
+//* There is no JIT for DFA matching.
+//*
+//* Flag 'u' matches UTF-8 with Unicode properties (PCRE2_UTF | PCRE2_UCP).
+//* A subject is validated once, when a search starts at 0, a RX_KEEP_POS loop
+//* or a scanner like rxForEach() goes on without checking it again. After
+//* changing a subject's bytes start over at 0. Searches go on at the next
+//* character, not byte, after an empty match or a limit hit.
+//*
+//* Flag 'o' (offsets only) fills just 'dasStart' and 'dasEnd' and leaves
+//* 'dacsMatch' empty. Submatch strings can be fetched on request after a match
+//* into a reused cstr:
+//*
+//*   rxGetMatch(&rxMatcher, 1, &csMatch);
+//*
 //* Single use:
 //*   const char* cSearchStr = "8.321654, 50.213456, 9, 49";
 //*   int         iErr       = 0;
@@ -114,6 +230,197 @@
 //*     ...
 //*   }
 //*
+//* With RX_LEN_MAX the subject's length is taken only once per loop. So don't
+//* change the subject string within a RX_KEEP_POS loop.
+//*
+//* Callback usage (fast path, no allocation per match):
+//*   int onMatch(const PCRE2_SIZE* psOvector, int iCount, void* pvUser) {
+//*     size_t sStart = psOvector[O_START(0)];
+//*     ...
+//*     return RX_RV_CONT;    // RX_RV_END stops the loop.
+//*   }
+//*
+//*   rv = rxForEach(&rxMatcher, pcBuf, sBufLen, onMatch, &myData, &csErr);
+//*   if (rv != RX_NO_ERROR) throwAnError();
+//*
+//* Replacing:
+//* The first or all matches are replaced into a cstr, whose memory is reused
+//* and only grows, if the result doesn't fit. '$n', '${n}' and '${name}' in
+//* the replacement insert submatches, '$$' a '$'. Return value is the number
+//* of replacements, errors are set like in rxMatch().
+//*
+//*   cstr csOut = csNew("");
+//*   rxInitMatcher(&rxMatcher, "(\\d+)\\.(\\d+)", "", &csErr);
+//*   rxReplace(&rxMatcher, "8.32, 50.21", RX_LEN_MAX, "$2.$1", &csOut, &iErr, &csErr);
+//*   // csOut.cStr is "32.8, 50.21".
+//*   rxReplaceAll(&rxMatcher, "8.32, 50.21", RX_LEN_MAX, "$2.$1", &csOut, &iErr, &csErr);
+//*   // csOut.cStr is "32.8, 21.50".
+//*
+//* Splitting:
+//* Like Perl's split(), fields between matches are set as (start, end) spans
+//* into a reused array, no field is copied. iLimit > 0 gives at most that
+//* many fields, 0 drops trailing empty fields, < 0 keeps them. With fCaptures
+//* submatches are added as fields, too (unset ones as PCRE2_UNSET).
+//*
+//*   t_array(t_rx_span) daFields;
+//*   daInit(t_rx_span, daFields);
+//*
+//*   rxInitMatcher(&rxMatcher, "\\s*,\\s*", "", &csErr);
+//*   rv = rxSplit(&rxMatcher, "a, b ,c", RX_LEN_MAX, 0, 0, &daFields, &csErr);
+//*   // Spans (0,1), (3,4), (6,7).
+//*
+//* Prefilter:
+//* If every match starts with the same bytes, the matcher jumps with memchr()
+//* from candidate to candidate and tries an anchored match only there. The
+//* pattern's first code unit is taken automatically, more bytes can be given:
+//*
+//*   rv = rxSetPrefix(&rxMatcher, "\x85\x19", 2, &csErr);
+//*
+//* The given bytes must begin every match, only the first one is checked. The
+//* pattern is compiled again then, set the prefix right after init.
+//* Each candidate costs an anchored match call, JIT's own search for the first
+//* code unit doesn't. So a longer prefix pays off, if few of its first bytes
+//* start a match, e.g. a short subject, that mostly holds none. If most
+//* candidates match, it's slower.
+//*
+//* Pattern sets:
+//* Many patterns are compiled into one alternation and a buffer is scanned only
+//* once. The callback gets the pattern's index, its submatches are numbered
+//* from 1 like in the single pattern. If more patterns match at the same
+//* offset, the one with the lowest index wins. Don't use (*MARK) in them.
+//* It's one leftmost scan, not one per pattern: Scanning goes on behind a
+//* match, so matches of other patterns overlapping it aren't reported. Flag
+//* 'x' is rejected, a comment would swallow the branch's mark. Don't use (?x)
+//* in the patterns for the same reason.
+//*
+//*   const char* apcRx[] = {"\x85\x19(.)", "\xf6\x1c(.{4})(.{4})"};
+//*   t_rx_set    rxSet   = {0};
+//*
+//*   int onSetMatch(int iId, const PCRE2_SIZE* psOvector, int iCount, void* pvUser) {
+//*     ...
+//*     return RX_RV_CONT;
+//*   }
+//*
+//*   rv = rxInitSet(&rxSet, apcRx, 2, "s", &csErr);
+//*   rv = rxSetForEach(&rxSet, pcBuf, sBufLen, onSetMatch, &myData, &csErr);
+//*   rxFreeSet(&rxSet);
+//*
+//* Streaming:
+//* Input is fed chunk by chunk, a match may span chunks and is reported once.
+//* Only the tail of a partial match (plus max lookbehind) is kept between
+//* chunks. 'sRightCtx' defers matches, which have less than that many bytes
+//* after their end, to the next chunk, so the callback can look ahead. The
+//* callback's ovector is relative to 'prxStream->pcBuf', the global offset is
+//* 'prxStream->sBase + psOvector[0]'. The last feed must be final.
+//*
+//*   int onStreamMatch(const t_rx_stream* prxStream, const PCRE2_SIZE* psOvector, int iCount, void* pvUser) {
+//*     ...
+//*     return RX_RV_CONT;
+//*   }
+//*
+//*   t_rx_stream rxStream = {0};
+//*   rxInitStream(&rxStream, &rxMatcher, 0);
+//*   while ((sRead = fread(pcChunk, 1, sChunkSize, hFile)) > 0)
+//*     rxStreamFeed(&rxStream, pcChunk, sRead, 0, onStreamMatch, &myData, &csErr);
+//*   rxStreamFeed(&rxStream, NULL, 0, 1, onStreamMatch, &myData, &csErr);
+//*   rxFreeStream(&rxStream);
+//*
+//* Reading directly into the stream's buffer saves a copy:
+//*
+//*   pcChunk = rxStreamSpace(&rxStream, sChunkSize);
+//*   sRead   = fread(pcChunk, 1, sChunkSize, hFile);
+//*   rxStreamFeed(&rxStream, pcChunk, sRead, 0, onStreamMatch, &myData, &csErr);
+//*
+//* Threads:
+//* A matcher is its compiled pattern plus match state (match data, JIT stack,
+//* context, results). Only the state changes while matching, so a pattern is
+//* compiled once and each thread gets its own cheap state for it:
+//*
+//*   t_rx_pattern rxPattern = {0};
+//*   rv = rxInitPattern(&rxPattern, crxCoord, "o", &csErr);
+//*   rv = rxSetPatternPrefix(&rxPattern, "\x85\x19", 2, &csErr);
+//*
+//*   // In each thread.
+//*   t_rx_matcher rxMatcher = {0};
+//*   rxInitMatcherShared(&rxMatcher, &rxPattern);
+//*   rv = rxForEach(&rxMatcher, pcBuf, sBufLen, onMatch, &myData, &csErr);
+//*   rxFreeMatcher(&rxMatcher);
+//*
+//*   // After all threads are done.
+//*   rxFreePattern(&rxPattern);
+//*
+//* Don't change a pattern (e.g. its prefix), while it is shared.
+//*
+//* Pattern cache:
+//* Compiled patterns can be stored in a directory and loaded on next start
+//* instead of being compiled again. A file is keyed by the final pattern, its
+//* compile options and the PCRE2 version. JIT code can't be stored, it is
+//* made after loading as usual. Any cache failure just compiles the pattern.
+//* A file is only decoded, if its size, key and hash of the bytes fit.
+//*
+//*   rv = rxInitPatternCached(&rxPattern, crxCoord, "o", "/tmp/rxcache", &csErr);
+//*   rv = rxInitMatcherCached(&rxMatcher, crxCoord, "o", "/tmp/rxcache", &csErr);
+//*
+//* Parallel scan:
+//* One large buffer is cut into ranges, which worker threads scan with their
+//* own state of a shared pattern. Each range's subject reaches 'sOverlap'
+//* bytes into the next one, set it to the longest expected match. Longer
+//* matches are still found, the overlap just grows then. The hits are merged
+//* into 'daHits' in offset order and without duplicates, exactly like a serial
+//* rxForEach() would find them. 0 threads means one per online CPU.
+//*
+//*   t_array(t_rx_hit) daHits;
+//*   daInit(t_rx_hit, daHits);
+//*
+//*   rv = rxParallelScan(&rxPattern, pcBuf, sBufLen, 0, 1024, &daHits, &csErr);
+//*   for (size_t i = 0; i < daHits.sCount; ++i)
+//*     printf("%zu-%zu\n", daHits.pVal[i].sStart, daHits.pVal[i].sEnd);
+//*
+//* Hits hold no submatches. rxMatch() at 'sStart' gets them, if needed.
+//*
+//* Limits:
+//* Each matcher has its own match context. Hostile data can make backtracking
+//* explode, so limits can be set per matcher (0 keeps the current value). The
+//* heap limit is in KiB, JIT knows only the match limit.
+//*
+//*   rxSetLimits(&rxMatcher, 100000, 10000, 1024);
+//*
+//* rxForEach(), rxStreamFeed() and rxParallelScan() skip a prefix candidate,
+//* which hits a limit, and go on with the next one. Without a prefix they skip
+//* one byte. rxMatch() returns with RX_LIMIT as error and sets the position
+//* behind the candidate, so a RX_KEEP_POS loop can just go on:
+//*
+//*   while (rxMatch(&rxMatcher, RX_KEEP_POS, pcStr, RX_LEN_MAX, &iErr, NULL) ||
+//*          iErr == RX_LIMIT) {
+//*     if (iErr == RX_LIMIT) continue;
+//*     ...
+//*   }
+//*
+//* Named groups:
+//* Each pattern hashes its group names once at init. Resolve names once and
+//* index by number afterwards, so a changed pattern needs no renumbering:
+//*
+//*   int iLon = rxGroupIndex(&rxMatcher, "lon");   // -1, if unknown.
+//*   ...
+//*   sStart = rxMatcher.dasStart.pVal[iLon];
+//*
+//* Of duplicate names ('(?J)') the lowest group number is taken.
+//*
+//* Profiling:
+//* A matcher counts its searches, if enabled. Time is taken around each
+//* search with CLOCK_MONOTONIC, so leave it off, if not needed.
+//*
+//*   t_rx_stats rxStats = {0};
+//*   rxEnableStats(&rxMatcher, 1);   // Resets all counters, too.
+//*   ...
+//*   rxGetStats(&rxMatcher, &rxStats);
+//*   rxPrintStats(&rxMatcher, "coords", stderr);
+//*
+//* Threads sharing a pattern have a matcher each. Their counters are summed
+//* up into one of them before printing:
+//*
+//*   rxAddStats(&rxMatcher, &rxThreadMatcher);
+//*
 //* Free used pcre and matcher memories before leaving:
 //*   rxFreeMatcher(&rxMatcher);
 //*
@@ -125,17 +432,134 @@
 s_array(cstr);
 s_array(size_t);
 
-// Control struct for global matching.
+// Callback for rxForEach(), gets ovector and number of its pairs.
+typedef int (*t_rx_callback)(const PCRE2_SIZE* psOvector, int iCount, void* pvUser);
+
+// Entry of a pattern's group name hash table. Name points into pcre2's
+// name table.
+typedef struct s_rx_name {
+  const char* pcName;
+  int         iGroup;
+} t_rx_name;
+
+// Compiled pattern. Read-only after init, so threads can share it.
+typedef struct s_rx_pattern {
+  pcre2_code* pRegex;
+  uint32_t    ui32Opts;
+  char*       pcRegex;      // Final pattern, to compile again for a prefix.
+  char*       pcCacheDir;   // NULL without cache.
+  int         fJitWanted;
+  int         fOffOnly;
+  char        acPrefix[RX_PREFIX_MAX];
+  size_t      sPrefixLen;
+  int         fJit;
+  int         fJitPartial;  // JIT code for PCRE2_PARTIAL_HARD, too.
+  int         fDfa;
+  uint32_t    ui32DfaOpts;  // PCRE2_DFA_SHORTEST or 0.
+  t_rx_name*  prxNames;     // Power of two slots, NULL without names.
+  uint32_t    ui32NameMask;
+} t_rx_pattern;
+
+// Profiling counters of one matcher.
+typedef struct s_rx_stats {
+  uint64_t ui64Calls;      // Searches started.
+  uint64_t ui64Matches;
+  uint64_t ui64NoMatches;
+  uint64_t ui64Bytes;      // Scanned from start offset to match end or end.
+  uint64_t ui64Empty;      // Empty matches, each costs a one byte advance.
+  uint64_t ui64LimitHits;  // Match, depth or heap limit exceeded.
+  uint64_t ui64Nsec;       // Time spent searching.
+  uint64_t ui64HeapPeak;   // Most bytes held by the matcher's allocator.
+} t_rx_stats;
+
+// Control struct for global matching, the match state of one thread.
 typedef struct s_rx_matcher {
-  size_t            sPos;
-  pcre2_match_data* pMatchData;
-  pcre2_code*       pRegex;
-  uint32_t          ui32Opts;
-  t_array(cstr)     dacsMatch;
-  t_array(size_t)   dasStart;
-  t_array(size_t)   dasEnd;
+  const t_rx_pattern*    prxPattern;  // Points to rxPattern or a shared one.
+  t_rx_pattern           rxPattern;   // Owned, if made by rxInitMatcher().
+  size_t                 sPos;
+  pcre2_match_data*      pMatchData;
+  const char*            pcSubject;
+  size_t                 sSubjectLen;
+  pcre2_jit_stack*       pJitStack;
+  pcre2_match_context*   pMatchCtx;
+  pcre2_general_context* pGenCtx;     // Allocator of all pcre2 memory.
+  size_t                 sHeapUsed;
+  size_t                 sLimitPos;   // Candidate of last limit hit.
+  const char*            pcUtfOk;     // Bytes validated as UTF-8.
+  size_t                 sUtfOkLen;
+  int*                   piDfaWork;
+  size_t                 sDfaWork;
+  int                    fStats;
+  t_rx_stats             rxStats;
+  t_array(cstr)          dacsMatch;
+  t_array(size_t)        dasStart;
+  t_array(size_t)        dasEnd;
 } t_rx_matcher;
 
+// Many patterns in one matcher, distinguished by (*MARK:<index>).
+typedef struct s_rx_set {
+  t_rx_matcher rxMatcher;
+  int          iCount;
+} t_rx_set;
+
+// Callback for rxSetForEach(), gets index of matching pattern, too.
+typedef int (*t_rx_set_callback)(int iId, const PCRE2_SIZE* psOvector, int iCount, void* pvUser);
+
+// Streaming state, buffer holds the retained tail and the current chunk.
+typedef struct s_rx_stream {
+  t_rx_matcher* prxMatcher;
+  char*         pcBuf;
+  size_t        sLen;         // Bytes used in pcBuf.
+  size_t        sCapacity;
+  size_t        sBase;        // Global offset of pcBuf[0].
+  size_t        sPos;         // Matching goes on here in pcBuf.
+  size_t        sLookBehind;  // Kept in front of sPos.
+  size_t        sRightCtx;    // Bytes needed after a match's end.
+  int           fDone;        // Callback stopped or final feed seen.
+} t_rx_stream;
+
+// Callback for rxStreamFeed(), ovector is relative to prxStream->pcBuf.
+typedef int (*t_rx_stream_callback)(const t_rx_stream* prxStream, const PCRE2_SIZE* psOvector, int iCount, void* pvUser);
+
+// Field of rxSplit(), offsets into the subject.
+typedef struct s_rx_span {
+  size_t sStart;
+  size_t sEnd;
+} t_rx_span;
+
+s_array(t_rx_span);
+
+// One match of rxParallelScan().
+typedef struct s_rx_hit {
+  size_t sStart;
+  size_t sEnd;
+  size_t sFrom;   // Internal, position the search for this hit began.
+} t_rx_hit;
+
+s_array(t_rx_hit);
+
+// Internal. Work shared by all threads of rxParallelScan().
+typedef struct s_rx_par_job {
+  const t_rx_pattern* prxPattern;
+  const char*         pcBuf;
+  size_t              sLen;
+  size_t              sRange;     // Bytes per range.
+  size_t              sRanges;
+  size_t              sOverlap;
+  size_t              sNext;      // Next range to scan, guarded by tLock.
+  pthread_mutex_t     tLock;
+  t_array(t_rx_hit)*  adaHits;    // Hits of each range.
+  int                 iMatchErr;  // First pcre2 error of any thread.
+  int                 fUtfOk;     // pcBuf is valid UTF-8.
+} t_rx_par_job;
+
+// Internal. Hands rxForEach() matches over to a t_rx_set_callback.
+typedef struct s_rx_set_relay {
+  t_rx_set*         prxSet;
+  t_rx_set_callback fCallback;
+  void*             pvUser;
+} t_rx_set_relay;
+
 
 //******************************************************************************
 //* function forward declarations
@@ -145,211 +569,1674 @@ typedef struct s_rx_matcher {
 //******************************************************************************
 //* public functions
 
+int  rxInitPattern(t_rx_pattern* prxPattern, const char* pcRegex, const char* pcFlags, cstr* pcsErr);
+int  rxInitPatternCached(t_rx_pattern* prxPattern, const char* pcRegex, const char* pcFlags, const char* pcCacheDir, cstr* pcsErr);
+void rxFreePattern(t_rx_pattern* prxPattern);
+int  rxSetPatternPrefix(t_rx_pattern* prxPattern, const char* pcPrefix, size_t sLen, cstr* pcsErr);
+int  rxInitMatcherShared(t_rx_matcher* prxMatcher, const t_rx_pattern* prxPattern);
 int  rxInitMatcher(t_rx_matcher* prxMatcher, const char* pcRegex, const char* pcFlags, cstr* pcsErr);
+int  rxInitMatcherCached(t_rx_matcher* prxMatcher, const char* pcRegex, const char* pcFlags, const char* pcCacheDir, cstr* pcsErr);
 void rxFreeMatcher(t_rx_matcher* prxMatcher);
 int        rxMatch(t_rx_matcher* prxMatcher, size_t sStartPos, const char* pcSearchStr, size_t sSearchLenMax, int* piErr, cstr* pcsErr);
+int     rxGetMatch(t_rx_matcher* prxMatcher, int iNum, cstr* pcsMatch);
+int      rxReplace(t_rx_matcher* prxMatcher, const char* pcSubject, size_t sLen, const char* pcReplace, cstr* pcsOut, int* piErr, cstr* pcsErr);
+int   rxReplaceAll(t_rx_matcher* prxMatcher, const char* pcSubject, size_t sLen, const char* pcReplace, cstr* pcsOut, int* piErr, cstr* pcsErr);
+int        rxSplit(t_rx_matcher* prxMatcher, const char* pcBuf, size_t sLen, int iLimit, int fCaptures, t_array(t_rx_span)* pdaFields, cstr* pcsErr);
+int      rxForEach(t_rx_matcher* prxMatcher, const char* pcBuf, size_t sLen, t_rx_callback fCallback, void* pvUser, cstr* pcsErr);
+int    rxSetPrefix(t_rx_matcher* prxMatcher, const char* pcPrefix, size_t sLen, cstr* pcsErr);
+int      rxInitSet(t_rx_set* prxSet, const char** apcRegex, int iCount, const char* pcFlags, cstr* pcsErr);
+void     rxFreeSet(t_rx_set* prxSet);
+int   rxSetForEach(t_rx_set* prxSet, const char* pcBuf, size_t sLen, t_rx_set_callback fCallback, void* pvUser, cstr* pcsErr);
+int   rxInitStream(t_rx_stream* prxStream, t_rx_matcher* prxMatcher, size_t sRightCtx);
+void  rxFreeStream(t_rx_stream* prxStream);
+char* rxStreamSpace(t_rx_stream* prxStream, size_t sLen);
+int   rxStreamFeed(t_rx_stream* prxStream, const char* pcChunk, size_t sLen, int fFinal, t_rx_stream_callback fCallback, void* pvUser, cstr* pcsErr);
+void  rxEnableStats(t_rx_matcher* prxMatcher, int fOn);
+void  rxGetStats(const t_rx_matcher* prxMatcher, t_rx_stats* prxStats);
+void  rxAddStats(t_rx_matcher* prxMatcher, const t_rx_matcher* prxFrom);
+void  rxPrintStats(const t_rx_matcher* prxMatcher, const char* pcName, FILE* hOut);
+void  rxSetLimits(t_rx_matcher* prxMatcher, uint32_t ui32Match, uint32_t ui32Depth, uint32_t ui32HeapKiB);
+int   rxPatternGroupIndex(const t_rx_pattern* prxPattern, const char* pcName);
+int   rxGroupIndex(const t_rx_matcher* prxMatcher, const char* pcName);
+int   rxParallelScan(const t_rx_pattern* prxPattern, const char* pcBuf, size_t sLen, int iThreads, size_t sOverlap, t_array(t_rx_hit)* pdaHits, cstr* pcsErr);
 
 
 //******************************************************************************
-//* public functions
+//* private functions
 
 /*******************************************************************************
- * Name: rxInitMatcher
+ * Name: rx_mem_alloc
+ * Purpose: Allocator of a matcher's pcre2 memory. Keeps the block size in a
+ *          header to count the bytes held and their peak.
  *******************************************************************************/
-int rxInitMatcher(t_rx_matcher* prxMatcher, const char* pcRegex, const char* pcFlags, cstr* pcsErr) {
-  cstr       csFlags = csNew(pcFlags);
-  cstr       csRegex = csNew(pcRegex);
-  int        iErr    = RX_NO_ERROR;
-  int        iErrNo  = 0;
-  PCRE2_SIZE iErrOff = 0;
+static void* rx_mem_alloc(PCRE2_SIZE sSize, void* pvMatcher) {
+  t_rx_matcher* prxMatcher = (t_rx_matcher*) pvMatcher;
+  char*         pcBlock    = (char*) malloc(sSize + RX_MEM_HEADER);
 
-  prxMatcher->sPos       = 0;
-  prxMatcher->pMatchData = NULL;
-  prxMatcher->pRegex     = NULL;
-  prxMatcher->ui32Opts   = 0;
+  if (pcBlock == NULL) return NULL;
 
-  // Init cstr and int arrays, which holds all matches and offsets.
-  daInit(cstr, prxMatcher->dacsMatch);
-  daInit(size_t, prxMatcher->dasStart);
-  daInit(size_t, prxMatcher->dasEnd);
+  *(size_t*) pcBlock = sSize;
+  prxMatcher->sHeapUsed += sSize;
+  if (prxMatcher->sHeapUsed > prxMatcher->rxStats.ui64HeapPeak)
+    prxMatcher->rxStats.ui64HeapPeak = prxMatcher->sHeapUsed;
 
-  // Convert option string into options and init everything to work global.
-  // Because PCRE2_EXTENDED don't work, I use the implicit form '(?x:...)'.
-  for (int i = 0; i < csFlags.len; ++i) {
-    if (csFlags.cStr[i] == 'x') {
-      csSetf(&csRegex, "(?x:%s)", csRegex.cStr);
-      continue;
+  return pcBlock + RX_MEM_HEADER;
+}
+
+/*******************************************************************************
+ * Name: rx_mem_free
+ *******************************************************************************/
+static void rx_mem_free(void* pvMem, void* pvMatcher) {
+  t_rx_matcher* prxMatcher = (t_rx_matcher*) pvMatcher;
+  char*         pcBlock    = (char*) pvMem - RX_MEM_HEADER;
+
+  if (pvMem == NULL) return;
+
+  prxMatcher->sHeapUsed -= *(size_t*) pcBlock;
+  free(pcBlock);
+}
+
+/*******************************************************************************
+ * Name: rx_exec
+ * Purpose: One match attempt at sPos, JIT or interpreter. Returns pcre2 rv.
+ *******************************************************************************/
+static int rx_exec(t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen, size_t sPos, uint32_t ui32Opts) {
+  const t_rx_pattern* prxP = prxMatcher->prxPattern;
+  int                 iRv  = 0;
+
+  // DFA reports only the whole match. Several ones at the same start, which
+  // may not fit into the ovector (rv 0), are longest first.
+  if (prxP->fDfa) {
+    for (;;) {
+      iRv = pcre2_dfa_match(
+        prxP->pRegex,                       // the compiled pattern
+        (PCRE2_SPTR) pcStr,                 // the subject string
+        sLen,                               // the length of the subject
+        sPos,                               // start at offset sPos
+        ui32Opts | prxP->ui32DfaOpts,       // options, shortest or not
+        prxMatcher->pMatchData,             // block for storing the result
+        prxMatcher->pMatchCtx,              // matcher's context
+        prxMatcher->piDfaWork,              // reused workspace
+        prxMatcher->sDfaWork                // its size in ints
+      );
+      if (iRv != PCRE2_ERROR_DFA_WSSIZE) break;
+      prxMatcher->sDfaWork  *= 2;
+      prxMatcher->piDfaWork  = (int*) realloc(prxMatcher->piDfaWork, sizeof(int) * prxMatcher->sDfaWork);
     }
-    if (csFlags.cStr[i] == 'i') {
-      prxMatcher->ui32Opts |= PCRE2_CASELESS;
-      continue;
+    return (iRv >= 0) ? 1 : iRv;
+  }
+
+  // JIT matching skips all sanity checks of pcre2_match() and its dispatch.
+  // Partial matching needs its own JIT code. An unchecked UTF subject must
+  // be checked by pcre2_match().
+  if (prxP->fJit && (prxP->fJitPartial || !(ui32Opts & PCRE2_PARTIAL_HARD)) &&
+      (!(prxP->ui32Opts & PCRE2_UTF) || (ui32Opts & PCRE2_NO_UTF_CHECK)))
+    return pcre2_jit_match(
+      prxP->pRegex,             // the compiled pattern
+      (PCRE2_SPTR) pcStr,       // the subject string
+      sLen,                     // the length of the subject
+      sPos,                     // start at offset sPos
+      ui32Opts,                 // options
+      prxMatcher->pMatchData,   // block for storing the result
+      prxMatcher->pMatchCtx     // matcher's context with JIT stack
+    );
+
+  return pcre2_match(
+    prxP->pRegex,             // the compiled pattern
+    (PCRE2_SPTR) pcStr,       // the subject string
+    sLen,                     // the length of the subject
+    sPos,                     // start at offset sPos
+    ui32Opts,                 // options
+    prxMatcher->pMatchData,   // block for storing the result
+    prxMatcher->pMatchCtx     // matcher's context
+  );
+}
+
+/*******************************************************************************
+ * Name: rx_set_relay
+ * Purpose: rxForEach() callback of rxSetForEach(), adds pattern's index.
+ *******************************************************************************/
+static int rx_set_relay(const PCRE2_SIZE* psOvector, int iCount, void* pvRelay) {
+  t_rx_set_relay* ptRelay = (t_rx_set_relay*) pvRelay;
+  PCRE2_SPTR      pcMark  = pcre2_get_mark(ptRelay->prxSet->rxMatcher.pMatchData);
+  int             iId     = (pcMark != NULL) ? atoi((const char*) pcMark) : -1;
+
+  return ptRelay->fCallback(iId, psOvector, iCount, ptRelay->pvUser);
+}
+
+/*******************************************************************************
+ * Name: rx_utf_valid
+ * Purpose: Checks UTF-8 like pcre2 does: no overlongs, surrogates, truncated
+ *          characters or code points above 0x10ffff. ASCII runs go by words.
+ *******************************************************************************/
+static int rx_utf_valid(const char* pcStr, size_t sLen) {
+  const unsigned char* puc    = (const unsigned char*) pcStr;
+  const unsigned char* pucEnd = puc + sLen;
+  uint64_t             ui64   = 0;
+  uint32_t             ui32Cp = 0;
+  int                  iMore  = 0;
+
+  while (puc < pucEnd) {
+    if ((size_t) (pucEnd - puc) >= sizeof(ui64)) {
+      memcpy(&ui64, puc, sizeof(ui64));
+      if ((ui64 & 0x8080808080808080ULL) == 0) {
+        puc += sizeof(ui64);
+        continue;
+      }
     }
-    if (csFlags.cStr[i] == 'm') {
-      prxMatcher->ui32Opts |= PCRE2_MULTILINE;
+
+    if (*puc < 0x80) {
+      ++puc;
       continue;
     }
-    if (csFlags.cStr[i] == 's') {
-      prxMatcher->ui32Opts |= PCRE2_DOTALL;
-      continue;
+    if      (*puc >= 0xc2 && *puc <= 0xdf) { iMore = 1; ui32Cp = *puc & 0x1f; }
+    else if (*puc >= 0xe0 && *puc <= 0xef) { iMore = 2; ui32Cp = *puc & 0x0f; }
+    else if (*puc >= 0xf0 && *puc <= 0xf4) { iMore = 3; ui32Cp = *puc & 0x07; }
+    else return 0;
+
+    if (pucEnd - puc <= iMore) return 0;
+    for (int i = 1; i <= iMore; ++i) {
+      if ((puc[i] & 0xc0) != 0x80) return 0;
+      ui32Cp = (ui32Cp << 6) | (puc[i] & 0x3f);
     }
-    if(pcsErr != NULL) csSetf(pcsErr, "Unkown option '%c'", csFlags.cStr[i]);
-    iErr = RX_ERROR;
-    goto free_and_exit;
+
+    if (iMore == 2 && (ui32Cp < 0x800 || (ui32Cp >= 0xd800 && ui32Cp <= 0xdfff))) return 0;
+    if (iMore == 3 && (ui32Cp < 0x10000 || ui32Cp > 0x10ffff)) return 0;
+    puc += iMore + 1;
   }
 
-  // Compile regex
-  prxMatcher->pRegex = pcre2_compile(
-    (PCRE2_SPTR) csRegex.cStr,  // the pattern
-    PCRE2_ZERO_TERMINATED,      // indicates pattern is zero-terminated
-    prxMatcher->ui32Opts,       // options
-    &iErrNo,                    // for error number
-    &iErrOff,                   // for error offset
-    NULL                        // use default compile context
-  );
+  return 1;
+}
 
-  // A fail will set pcsErr with the error string and return RX_ERROR.
-  if (prxMatcher->pRegex == NULL) {
-    PCRE2_UCHAR buffer[256];
-    pcre2_get_error_message(iErrNo, buffer, sizeof(buffer));
-    csSetf(pcsErr, "Compilation failed at %d: %s", iErrOff, buffer);
-    iErr = RX_ERROR;
-  }
+/*******************************************************************************
+ * Name: rx_utf_opts
+ * Purpose: Returns PCRE2_NO_UTF_CHECK, if the subject lies within the bytes
+ *          validated last, cut at character boundaries. Else it's validated
+ *          now. Invalid ones are left to pcre2 to report.
+ *******************************************************************************/
+static uint32_t rx_utf_opts(t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen) {
+  const char* pcOk    = prxMatcher->pcUtfOk;
+  const char* pcOkEnd = pcOk + prxMatcher->sUtfOkLen;
 
-free_and_exit:
-  csFree(&csFlags);
-  csFree(&csRegex);
+  if (pcOk != NULL && pcStr >= pcOk && pcStr + sLen <= pcOkEnd &&
+      (pcStr == pcOk || (pcStr[0] & 0xc0) != 0x80) &&
+      (pcStr + sLen == pcOkEnd || (pcStr[sLen] & 0xc0) != 0x80))
+    return PCRE2_NO_UTF_CHECK;
 
-  return iErr;
+  prxMatcher->pcUtfOk   = rx_utf_valid(pcStr, sLen) ? pcStr : NULL;
+  prxMatcher->sUtfOkLen = sLen;
+
+  return (prxMatcher->pcUtfOk != NULL) ? PCRE2_NO_UTF_CHECK : 0;
 }
 
 /*******************************************************************************
- * Name: rxFreeMatcher
+ * Name: rx_utf_next
+ * Purpose: Position behind the character at sPos, one byte if not UTF.
  *******************************************************************************/
-void rxFreeMatcher(t_rx_matcher* prxMatcher) {
-  pcre2_match_data_free(prxMatcher->pMatchData);
-  pcre2_code_free(prxMatcher->pRegex);
-  daFreeEx(prxMatcher->dacsMatch, cStr);
-  daFree(prxMatcher->dasStart);
-  daFree(prxMatcher->dasEnd);
+static size_t rx_utf_next(const t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen, size_t sPos) {
+  ++sPos;
+  if (prxMatcher->prxPattern->ui32Opts & PCRE2_UTF)
+    while (sPos < sLen && (pcStr[sPos] & 0xc0) == 0x80) ++sPos;
+  return sPos;
 }
 
 /*******************************************************************************
- * Name: rxMatch
+ * Name: rx_utf_trim
+ * Purpose: Length without a character cut off at the end, one byte if not
+ *          UTF. Partial matching waits for its bytes then.
  *******************************************************************************/
-int rxMatch(t_rx_matcher* prxMatcher, size_t sStartPos, const char* pcSearchStr, size_t sSearchLenMax, int* piErr, cstr* pcsErr) {
-  PCRE2_SPTR  pcStr       = (PCRE2_SPTR) pcSearchStr;
-  size_t      sStrLength  = 0;
-  PCRE2_SPTR  pcSubStr    = NULL;
-  cstr        csSubStr    = csNew("");
-  size_t      sSubStrLen  = 0;
-  int         iMatchCount = 0;
-  int         iRv         = RX_RV_CONT;
-  PCRE2_SIZE* psOvector   = NULL;
-
-  if (sSearchLenMax == RX_LEN_MAX)
-    sStrLength = strlen(pcSearchStr);
-  else
-    sStrLength = sSearchLenMax;
+static size_t rx_utf_trim(const t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen) {
+  size_t sLead = sLen;
 
-  // Init error value to none.
-  if (piErr != NULL) *piErr = RX_NO_ERROR;
+  if (!(prxMatcher->prxPattern->ui32Opts & PCRE2_UTF))
+    return sLen;
 
-  //****************************************************************************
-  //* The actual matching function block.
-  //****************************************************************************
+  while (sLead > 0 && sLen - sLead < 3 && (pcStr[sLead - 1] & 0xc0) == 0x80) --sLead;
+  if (sLead == 0 || (unsigned char) pcStr[sLead - 1] < 0xc0)
+    return sLen;
 
-  // Create enough space for all parentheses and match strings.
-  if (prxMatcher->pMatchData != NULL)
-    pcre2_match_data_free(prxMatcher->pMatchData);
-  prxMatcher->pMatchData = pcre2_match_data_create_from_pattern(prxMatcher->pRegex, NULL);
+  // Lead byte's count of bytes, e.g. 0xe0 starts three ones.
+  --sLead;
+  if (sLen - sLead < (size_t) (((unsigned char) pcStr[sLead] >= 0xf0) ? 4 : ((unsigned char) pcStr[sLead] >= 0xe0) ? 3 : 2))
+    return sLead;
 
-  // Set pos to start from if wanted.
-  if (sStartPos != RX_KEEP_POS)
-    prxMatcher->sPos = sStartPos;
+  return sLen;
+}
 
-  iMatchCount = pcre2_match(
-    prxMatcher->pRegex,       // the compiled pattern
-    pcStr,                    // the subject string
-    sStrLength,               // the length of the subject
-    prxMatcher->sPos,         // start at offset iPos
-    prxMatcher->ui32Opts,     // options
-    prxMatcher->pMatchData,   // block for storing the result
-    NULL                      // use default match context
-  );
+/*******************************************************************************
+ * Name: rx_search
+ * Purpose: Like rx_exec(), but with a literal prefix memchr() and memcmp() look
+ *          for candidates first. Each candidate is matched with the offset
+ *          limit set to it, which anchors the match there, JIT or not.
+ *          A limit hit keeps the candidate in sLimitPos for skipping it.
+ *******************************************************************************/
+static int rx_search(t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen, size_t sPos, uint32_t ui32Opts) {
+  const char* pcCand = NULL;
+  const char* pcEnd  = pcStr + sLen;
+  const char* pcPfx  = prxMatcher->prxPattern->acPrefix;
+  size_t      sPfx   = prxMatcher->prxPattern->sPrefixLen;
+  size_t      sTail  = 0;
+  int         iRv    = PCRE2_ERROR_NOMATCH;
 
-  //****************************************************************************
-  //* Error handling.
-  //****************************************************************************
+  // pcre2_jit_match() doesn't check the start offset.
+  if (sPos > sLen)
+    return PCRE2_ERROR_NOMATCH;
 
-  if (iMatchCount == PCRE2_ERROR_NOMATCH) {   // Just no match, no error!
-    if (pcsErr != NULL) csSet(pcsErr, "No match");
-    if (piErr  != NULL) *piErr = RX_NO_MATCH;
-    iRv    = RX_RV_END;
-    prxMatcher->sPos = 0;
-    goto free_and_exit;
+  // Without prefix the failing start offset is unknown.
+  if (sPfx < 2) {
+    iRv = rx_exec(prxMatcher, pcStr, sLen, sPos, ui32Opts);
+    if (RX_IS_LIMIT(iRv)) prxMatcher->sLimitPos = sPos;
+    return iRv;
   }
-  if (iMatchCount < 0) {                      // Matching failed.
-    if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iMatchCount);
-    if (piErr  != NULL) *piErr = RX_ERROR;
-    iRv    = RX_RV_END;
-    goto free_and_exit;
+
+  pcCand = pcStr + sPos;
+  while ((size_t) (pcEnd - pcCand) >= sPfx) {
+    pcCand = (const char*) memchr(pcCand, pcPfx[0], pcEnd - pcCand - sPfx + 1);
+    if (pcCand == NULL) break;
+
+    if (memcmp(pcCand + 1, pcPfx + 1, sPfx - 1) == 0) {
+      pcre2_set_offset_limit(prxMatcher->pMatchCtx, pcCand - pcStr);
+      iRv = rx_exec(prxMatcher, pcStr, sLen, pcCand - pcStr, ui32Opts);
+      if (RX_IS_LIMIT(iRv)) prxMatcher->sLimitPos = pcCand - pcStr;
+      if (iRv != PCRE2_ERROR_NOMATCH) break;
+    }
+
+    ++pcCand;
   }
-  if (iMatchCount == 0) {                     // Creating output vector failed.
-    if (pcsErr != NULL) csSet(pcsErr, "'ovector' was not big enough for all captured substrings");
-    if (piErr  != NULL) *piErr = RX_NO_VECTOR;
-    iRv    = RX_RV_END;
-    goto free_and_exit;
+
+  pcre2_set_offset_limit(prxMatcher->pMatchCtx, PCRE2_UNSET);
+
+  // A prefix cut off at the end may still be a partial match.
+  if (iRv == PCRE2_ERROR_NOMATCH && (ui32Opts & (PCRE2_PARTIAL_HARD | PCRE2_PARTIAL_SOFT))) {
+    sTail = (sLen - sPos >= sPfx) ? sLen - sPfx + 1 : sPos;
+    if (sTail > sPos) sTail = rx_utf_next(prxMatcher, pcStr, sLen, sTail - 1);
+    iRv   = rx_exec(prxMatcher, pcStr, sLen, sTail, ui32Opts);
+    if (RX_IS_LIMIT(iRv)) prxMatcher->sLimitPos = sTail;
   }
 
-  //****************************************************************************
-  //* Match succeded. Get a pointer to the output vector, where string offsets
-  //* are stored. Cram all matches into a dynamic cstr array.
-  //****************************************************************************
+  return iRv;
+}
 
-  psOvector = pcre2_get_ovector_pointer(prxMatcher->pMatchData);
-  daClearEx(cstr, prxMatcher->dacsMatch, cStr);
-  daClear(size_t, prxMatcher->dasStart);
-  daClear(size_t, prxMatcher->dasEnd);
+/*******************************************************************************
+ * Name: rx_find
+ * Purpose: rx_search() counting into the matcher's stats, if enabled.
+ *******************************************************************************/
+static int rx_find(t_rx_matcher* prxMatcher, const char* pcStr, size_t sLen, size_t sPos, uint32_t ui32Opts) {
+  t_rx_stats*       prxS      = &prxMatcher->rxStats;
+  const PCRE2_SIZE* psOvector = NULL;
+  struct timespec   tStart    = {0};
+  struct timespec   tEnd      = {0};
+  int               iRv       = 0;
 
-  for (int i = 0; i < iMatchCount; ++i) {
-    // Get offset and length of a match ...
-    pcSubStr   = pcStr               + psOvector[O_START(i)];
-    sSubStrLen = psOvector[O_END(i)] - psOvector[O_START(i)];
+  // Unchecked pcre2 must not start within a character.
+  if (prxMatcher->prxPattern->ui32Opts & PCRE2_UTF) {
+    if (sPos < sLen && (pcStr[sPos] & 0xc0) == 0x80)
+      return PCRE2_ERROR_BADUTFOFFSET;
+    ui32Opts |= rx_utf_opts(prxMatcher, pcStr, sLen);
+  }
 
-    // ... save start and end offsets in dynamic arrays, too ...
-    daAdd(size_t, prxMatcher->dasStart, psOvector[O_START(i)]);
-    daAdd(size_t, prxMatcher->dasEnd,   psOvector[O_END(i)]);
+  if (! prxMatcher->fStats)
+    return rx_search(prxMatcher, pcStr, sLen, sPos, ui32Opts);
+
+  clock_gettime(CLOCK_MONOTONIC, &tStart);
+  iRv = rx_search(prxMatcher, pcStr, sLen, sPos, ui32Opts);
+  clock_gettime(CLOCK_MONOTONIC, &tEnd);
+
+  prxS->ui64Nsec += (tEnd.tv_sec - tStart.tv_sec) * 1000000000LL + (tEnd.tv_nsec - tStart.tv_nsec);
+  ++prxS->ui64Calls;
 
-    // ... and add it to the dynamic array via temporary cstr.
-    csSetf(&csSubStr, "%.*s", sSubStrLen, pcSubStr);
-    daAdd(cstr, prxMatcher->dacsMatch, csNew(csSubStr.cStr));
+  if (iRv >= 0) {
+    psOvector = pcre2_get_ovector_pointer(prxMatcher->pMatchData);
+    ++prxS->ui64Matches;
+    prxS->ui64Bytes += psOvector[O_END(0)] - sPos;
+    if (psOvector[O_END(0)] == psOvector[O_START(0)]) ++prxS->ui64Empty;
+  }
+  else {
+    if (iRv == PCRE2_ERROR_NOMATCH) ++prxS->ui64NoMatches;
+    if (RX_IS_LIMIT(iRv)) ++prxS->ui64LimitHits;
+    if (sLen > sPos) prxS->ui64Bytes += sLen - sPos;
   }
 
-  // Store end of complete match as pos().
-  prxMatcher->sPos = psOvector[O_END(0)];
+  return iRv;
+}
 
-  // If the match was an empty string, hop along one pos.
-  if (psOvector[O_END(0)] == psOvector[O_START(0)]) {
-    if (pcsErr != NULL) csSet(pcsErr, "Empty string");
-    if (piErr  != NULL) *piErr = RX_NO_ERROR;
-    iRv    = RX_RV_CONT;
-    ++prxMatcher->sPos;
-    goto free_and_exit;
+/*******************************************************************************
+ * Name: rx_substitute
+ * Purpose: pcre2_substitute() into pcsOut. If it doesn't fit, pcre2 tells the
+ *          needed length and it's done once more with enough memory.
+ *******************************************************************************/
+static int rx_substitute(t_rx_matcher* prxMatcher, const char* pcSubject, size_t sLen, const char* pcReplace, uint32_t ui32Opts, cstr* pcsOut, int* piErr, cstr* pcsErr) {
+  PCRE2_SIZE sOutLen = 0;
+  int        iRv     = 0;
+
+  if (piErr != NULL) *piErr = RX_NO_ERROR;
+  if (sLen == RX_LEN_MAX) sLen = strlen(pcSubject);
+
+  csReserve(pcsOut, sLen + 1);
+
+  for (int i = 0; i < 2; ++i) {
+    sOutLen = pcsOut->capacity;
+    iRv     = pcre2_substitute(
+      prxMatcher->prxPattern->pRegex,         // the compiled pattern
+      (PCRE2_SPTR) pcSubject,                 // the subject string
+      sLen,                                   // the length of the subject
+      0,                                      // start at offset 0
+      ui32Opts |                              // options and get needed
+        PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,     // length, if too short
+      prxMatcher->pMatchData,                 // block for storing the result
+      prxMatcher->pMatchCtx,                  // matcher's context
+      (PCRE2_SPTR) pcReplace,                 // the replacement
+      PCRE2_ZERO_TERMINATED,                  // which is zero-terminated
+      (PCRE2_UCHAR*) pcsOut->cStr,            // output buffer
+      &sOutLen                                // its size, then used length
+    );
+    if (iRv != PCRE2_ERROR_NOMEMORY) break;
+    csReserve(pcsOut, sOutLen);
   }
 
-  if (psOvector[0] >= sStrLength) {
-    if (pcsErr != NULL) csSet(pcsErr, "End of subject");
-    if (piErr  != NULL) *piErr = RX_NO_ERROR;
-    iRv    = RX_RV_END;
-    prxMatcher->sPos = 0;
-    goto free_and_exit;
+  if (iRv < 0) {
+    PCRE2_UCHAR buffer[256];
+    pcre2_get_error_message(iRv, buffer, sizeof(buffer));
+    if (pcsErr != NULL) csSetf(pcsErr, "Substitution failed: %s", buffer);
+    if (piErr  != NULL) *piErr = RX_IS_LIMIT(iRv) ? RX_LIMIT : RX_ERROR;
+    csSetMem(pcsOut, "", 0);
+    return 0;
   }
 
-free_and_exit:
-  csFree(&csSubStr);
+  // pcre2 wrote into the cstr's memory, just set the length.
+  csSetMem(pcsOut, pcsOut->cStr, sOutLen);
 
   return iRv;
 }
 
+/*******************************************************************************
+ * Name: rx_name_hash
+ * Purpose: 32 bit FNV-1a hash of a group name.
+ *******************************************************************************/
+static uint32_t rx_name_hash(const char* pcName) {
+  uint32_t ui32Hash = 0x811c9dc5;
+
+  for (; *pcName != '\0'; ++pcName) {
+    ui32Hash ^= (unsigned char) *pcName;
+    ui32Hash *= 0x01000193;
+  }
+  return ui32Hash;
+}
+
+/*******************************************************************************
+ * Name: rx_names_init
+ * Purpose: Hashes pcre2's name table into at least twice as many slots with
+ *          linear probing. Entries of the table are group number (2 bytes,
+ *          big endian) and name. Equal names are in group order, the first one
+ *          stays.
+ *******************************************************************************/
+static void rx_names_init(t_rx_pattern* prxPattern) {
+  PCRE2_SPTR  pcTable  = NULL;
+  const char* pcName   = NULL;
+  uint32_t    ui32Cnt  = 0;
+  uint32_t    ui32Size = 0;
+  uint32_t    ui32Slot = 0;
+  uint32_t    ui32Mask = 1;
+
+  pcre2_pattern_info(prxPattern->pRegex, PCRE2_INFO_NAMECOUNT,     &ui32Cnt);
+  pcre2_pattern_info(prxPattern->pRegex, PCRE2_INFO_NAMEENTRYSIZE, &ui32Size);
+  pcre2_pattern_info(prxPattern->pRegex, PCRE2_INFO_NAMETABLE,     &pcTable);
+  if (ui32Cnt == 0) return;
+
+  while (ui32Mask + 1 < 2 * ui32Cnt) ui32Mask = (ui32Mask << 1) | 1;
+  prxPattern->prxNames     = (t_rx_name*) calloc(ui32Mask + 1, sizeof(t_rx_name));
+  prxPattern->ui32NameMask = ui32Mask;
+
+  for (uint32_t i = 0; i < ui32Cnt; ++i, pcTable += ui32Size) {
+    pcName   = (const char*) pcTable + 2;
+    ui32Slot = rx_name_hash(pcName) & ui32Mask;
+    while (prxPattern->prxNames[ui32Slot].pcName != NULL &&
+           strcmp(prxPattern->prxNames[ui32Slot].pcName, pcName) != 0)
+      ui32Slot = (ui32Slot + 1) & ui32Mask;
+    if (prxPattern->prxNames[ui32Slot].pcName != NULL) continue;
+
+    prxPattern->prxNames[ui32Slot].pcName = pcName;
+    prxPattern->prxNames[ui32Slot].iGroup = (pcTable[0] << 8) | pcTable[1];
+  }
+}
+
+/*******************************************************************************
+ * Name: rx_hash
+ * Purpose: Returns the 64 bit FNV-1a hash of sLen bytes.
+ *******************************************************************************/
+static uint64_t rx_hash(const void* pvBytes, size_t sLen) {
+  const unsigned char* pucBytes = (const unsigned char*) pvBytes;
+  uint64_t             ui64Hash = 0xcbf29ce484222325ULL;
+
+  for (size_t i = 0; i < sLen; ++i) {
+    ui64Hash ^= pucBytes[i];
+    ui64Hash *= 0x100000001b3ULL;
+  }
+
+  return ui64Hash;
+}
+
+/*******************************************************************************
+ * Name: rx_cache_key
+ * Purpose: Sets cache key and file path of a pattern. File name is the key's
+ *          hash, the key itself is stored in the file.
+ *******************************************************************************/
+static void rx_cache_key(cstr* pcsKey, cstr* pcsPath, const char* pcCacheDir, const char* pcRegex, uint32_t ui32Opts) {
+  char acVersion[64] = {0};
+
+  pcre2_config(PCRE2_CONFIG_VERSION, acVersion);
+  csSetf(pcsKey, "%s\n%08x\n%s", acVersion, ui32Opts, pcRegex);
+  csSetf(pcsPath, "%s/rx_%016llx.pcre2", pcCacheDir, (unsigned long long) rx_hash(pcsKey->cStr, pcsKey->len));
+}
+
+/*******************************************************************************
+ * Name: rx_cache_load
+ * Purpose: Returns the decoded pattern of a cache file or NULL, if there is
+ *          none, it doesn't belong to the key or is damaged. Lengths must add
+ *          up to the file size, pcre2 doesn't check the bytes, so they must
+ *          fit their hash.
+ *          Layout: magic, key length, key, serialized bytes length, hash of
+ *                  the bytes, bytes.
+ *******************************************************************************/
+static pcre2_code* rx_cache_load(const char* pcPath, const cstr* pcsKey) {
+  FILE*       hFile    = fopen(pcPath, "rb");
+  pcre2_code* pCode    = NULL;
+  char*       pcKey    = NULL;
+  uint8_t*    pBytes   = NULL;
+  char        acMagic[sizeof(RX_CACHE_MAGIC) - 1];
+  struct stat tStat;
+  uint64_t    ui64Key  = 0;
+  uint64_t    ui64Len  = 0;
+  uint64_t    ui64Hash = 0;
+  uint64_t    ui64Head = sizeof(acMagic) + 3 * sizeof(uint64_t);
+
+  if (hFile == NULL) return NULL;
+
+  if (fstat(fileno(hFile), &tStat) != 0 ||
+      tStat.st_size < (off_t) ui64Head || tStat.st_size > RX_CACHE_SIZE_MAX)
+    goto free_and_exit;
+
+  if (fread(acMagic, sizeof(acMagic), 1, hFile) != 1 ||
+      memcmp(acMagic, RX_CACHE_MAGIC, sizeof(acMagic)) != 0 ||
+      fread(&ui64Key, sizeof(ui64Key), 1, hFile) != 1 ||
+      ui64Key != (uint64_t) pcsKey->len ||
+      ui64Key > (uint64_t) tStat.st_size - ui64Head)
+    goto free_and_exit;
+
+  if ((pcKey = (char*) malloc(ui64Key)) == NULL ||
+      fread(pcKey, 1, ui64Key, hFile) != ui64Key ||
+      memcmp(pcKey, pcsKey->cStr, ui64Key) != 0 ||
+      fread(&ui64Len, sizeof(ui64Len), 1, hFile) != 1 ||
+      fread(&ui64Hash, sizeof(ui64Hash), 1, hFile) != 1 ||
+      ui64Len != (uint64_t) tStat.st_size - ui64Head - ui64Key || ui64Len == 0)
+    goto free_and_exit;
+
+  if ((pBytes = (uint8_t*) malloc(ui64Len)) == NULL ||
+      fread(pBytes, 1, ui64Len, hFile) != ui64Len ||
+      rx_hash(pBytes, ui64Len) != ui64Hash)
+    goto free_and_exit;
+
+  if (pcre2_serialize_get_number_of_codes(pBytes) != 1 ||
+      pcre2_serialize_decode(&pCode, 1, pBytes, NULL) != 1) {
+    pcre2_code_free(pCode);
+    pCode = NULL;
+  }
+
+free_and_exit:
+  free(pcKey);
+  free(pBytes);
+  fclose(hFile);
+
+  return pCode;
+}
+
+/*******************************************************************************
+ * Name: rx_cache_save
+ * Purpose: Stores a compiled pattern. Written to a temporary file first and
+ *          renamed, so concurrent runs never see a half written file.
+ *******************************************************************************/
+static void rx_cache_save(const char* pcPath, const cstr* pcsKey, const pcre2_code* pCode) {
+  cstr        csTmp    = csNew("");
+  FILE*       hFile    = NULL;
+  uint8_t*    pBytes   = NULL;
+  PCRE2_SIZE  sBytes   = 0;
+  uint64_t    ui64Key  = pcsKey->len;
+  uint64_t    ui64Len  = 0;
+  uint64_t    ui64Hash = 0;
+  int         fOk      = 0;
+
+  if (pcre2_serialize_encode(&pCode, 1, &pBytes, &sBytes, NULL) != 1)
+    goto free_and_exit;
+  ui64Len  = sBytes;
+  ui64Hash = rx_hash(pBytes, sBytes);
+
+  csSetf(&csTmp, "%s.%ld", pcPath, (long) getpid());
+  if ((hFile = fopen(csTmp.cStr, "wb")) == NULL)
+    goto free_and_exit;
+
+  fOk = fwrite(RX_CACHE_MAGIC, sizeof(RX_CACHE_MAGIC) - 1, 1, hFile) == 1 &&
+        fwrite(&ui64Key, sizeof(ui64Key), 1, hFile) == 1 &&
+        fwrite(pcsKey->cStr, 1, ui64Key, hFile) == ui64Key &&
+        fwrite(&ui64Len, sizeof(ui64Len), 1, hFile) == 1 &&
+        fwrite(&ui64Hash, sizeof(ui64Hash), 1, hFile) == 1 &&
+        fwrite(pBytes, 1, ui64Len, hFile) == ui64Len;
+  fOk = (fclose(hFile) == 0) && fOk;
+
+  if (! fOk || rename(csTmp.cStr, pcPath) != 0)
+    remove(csTmp.cStr);
+
+free_and_exit:
+  pcre2_serialize_free(pBytes);
+  csFree(&csTmp);
+}
+
+/*******************************************************************************
+ * Name: rx_compile
+ * Purpose: Compiles a pattern's final regex with its options or loads it from
+ *          the cache. Makes its names table and JIT code. A pattern without
+ *          prefix takes a fixed first code unit as one.
+ *******************************************************************************/
+static int rx_compile(t_rx_pattern* prxPattern, cstr* pcsErr) {
+  cstr       csKey   = csNew("");
+  cstr       csPath  = csNew("");
+  int        fCached = 0;
+  int        iErr    = RX_NO_ERROR;
+  int        iErrNo  = 0;
+  PCRE2_SIZE iErrOff = 0;
+  uint32_t   ui32Jit = 0;
+  uint32_t   ui32Cu  = 0;
+
+  // Try cache first.
+  if (prxPattern->pcCacheDir != NULL) {
+    rx_cache_key(&csKey, &csPath, prxPattern->pcCacheDir, prxPattern->pcRegex, prxPattern->ui32Opts);
+    prxPattern->pRegex = rx_cache_load(csPath.cStr, &csKey);
+  }
+
+  fCached = (prxPattern->pRegex != NULL);
+
+  // Compile regex
+  if (! fCached)
+    prxPattern->pRegex = pcre2_compile(
+      (PCRE2_SPTR) prxPattern->pcRegex, // the pattern
+      PCRE2_ZERO_TERMINATED,            // indicates pattern is zero-terminated
+      prxPattern->ui32Opts,             // options
+      &iErrNo,                          // for error number
+      &iErrOff,                         // for error offset
+      NULL                              // use default compile context
+    );
+
+  // A fail will set pcsErr with the error string and return RX_ERROR.
+  if (prxPattern->pRegex == NULL) {
+    PCRE2_UCHAR buffer[256];
+    pcre2_get_error_message(iErrNo, buffer, sizeof(buffer));
+    if (pcsErr != NULL) csSetf(pcsErr, "Compilation failed at %d: %s", iErrOff, buffer);
+    iErr = RX_ERROR;
+    goto free_and_exit;
+  }
+
+  // A freshly compiled pattern goes into the cache.
+  if (prxPattern->pcCacheDir != NULL && ! fCached)
+    rx_cache_save(csPath.cStr, &csKey, prxPattern->pRegex);
+
+  rx_names_init(prxPattern);
+
+  // Take a fixed first code unit as prefix. Caseless it's ambiguous.
+  pcre2_pattern_info(prxPattern->pRegex, PCRE2_INFO_FIRSTCODETYPE, &ui32Cu);
+  if (prxPattern->sPrefixLen == 0 && ui32Cu == 1 && !(prxPattern->ui32Opts & PCRE2_CASELESS)) {
+    pcre2_pattern_info(prxPattern->pRegex, PCRE2_INFO_FIRSTCODEUNIT, &ui32Cu);
+    prxPattern->acPrefix[0] = (char) ui32Cu;
+    prxPattern->sPrefixLen  = 1;
+  }
+
+  // JIT compile, if wanted and supported. Any JIT error falls back silently to
+  // the interpreter, which is always working. DFA has no JIT.
+  prxPattern->fJit        = 0;
+  prxPattern->fJitPartial = 0;
+  if (prxPattern->fJitWanted && ! prxPattern->fDfa) pcre2_config(PCRE2_CONFIG_JIT, &ui32Jit);
+  if (ui32Jit == 1 && pcre2_jit_compile(prxPattern->pRegex, PCRE2_JIT_COMPLETE) == 0) {
+    prxPattern->fJit        = 1;
+    prxPattern->fJitPartial = (pcre2_jit_compile(prxPattern->pRegex, PCRE2_JIT_PARTIAL_HARD) == 0);
+  }
+
+free_and_exit:
+  csFree(&csKey);
+  csFree(&csPath);
+
+  return iErr;
+}
+
+/*******************************************************************************
+ * Name: rx_cmp_hit
+ * Purpose: Orders hits by start offset for hpMerge().
+ *******************************************************************************/
+static int rx_cmp_hit(const void* pvA, const void* pvB) {
+  const t_rx_hit* ptA = (const t_rx_hit*) pvA;
+  const t_rx_hit* ptB = (const t_rx_hit*) pvB;
+
+  return (ptA->sStart > ptB->sStart) - (ptA->sStart < ptB->sStart);
+}
+
+/*******************************************************************************
+ * Name: rx_par_worker
+ * Purpose: Thread of rxParallelScan(). Takes ranges until all are done and
+ *          collects all hits starting within them. The subject ends sOverlap
+ *          bytes behind the range. A partial match there doubles the overlap
+ *          and is tried again from its start, so no match is cut.
+ *******************************************************************************/
+static void* rx_par_worker(void* pvJob) {
+  t_rx_par_job*     ptJob     = (t_rx_par_job*) pvJob;
+  t_rx_matcher      rxMatcher = {0};
+  const PCRE2_SIZE* psOvector = NULL;
+  t_rx_hit          tHit      = {0};
+  size_t            sRange    = 0;
+  size_t            sPos      = 0;
+  size_t            sFrom     = 0;
+  size_t            sStop     = 0;
+  size_t            sExt      = 0;
+  size_t            sSubj     = 0;
+  uint32_t          ui32Opts  = 0;
+  int               iRv       = 0;
+
+  rxInitMatcherShared(&rxMatcher, ptJob->prxPattern);
+  psOvector = pcre2_get_ovector_pointer(rxMatcher.pMatchData);
+
+  // Buffer was validated once by rxParallelScan().
+  if (ptJob->fUtfOk) {
+    rxMatcher.pcUtfOk   = ptJob->pcBuf;
+    rxMatcher.sUtfOkLen = ptJob->sLen;
+  }
+
+  for (;;) {
+    pthread_mutex_lock(&ptJob->tLock);
+    sRange = ptJob->sNext++;
+    pthread_mutex_unlock(&ptJob->tLock);
+    if (sRange >= ptJob->sRanges) break;
+
+    // Last range takes an empty match at the very end, too. A range starts
+    // at a character, the bytes before belong to the previous one.
+    sPos  = sRange * ptJob->sRange;
+    sStop = (sRange + 1 == ptJob->sRanges) ? ptJob->sLen + 1 : sPos + ptJob->sRange;
+    sExt  = (ptJob->sOverlap > 0) ? ptJob->sOverlap : 1;
+    if (sPos > 0) sPos = rx_utf_next(&rxMatcher, ptJob->pcBuf, ptJob->sLen, sPos - 1);
+    sFrom = sPos;
+
+    while (sPos < sStop) {
+      sSubj    = (sStop > ptJob->sLen || ptJob->sLen - sStop <= sExt) ? ptJob->sLen : sStop + sExt;
+      ui32Opts = (sSubj < ptJob->sLen) ? PCRE2_PARTIAL_HARD : 0;
+      if (ui32Opts) sSubj = rx_utf_trim(&rxMatcher, ptJob->pcBuf, sSubj);
+      iRv      = rx_find(&rxMatcher, ptJob->pcBuf, sSubj, sPos, ui32Opts);
+
+      // No match before the partial one, which may start in the next range.
+      if (iRv == PCRE2_ERROR_PARTIAL) {
+        if (psOvector[O_START(0)] >= sStop) break;
+        sPos  = psOvector[O_START(0)];
+        sExt *= 2;
+        continue;
+      }
+      if (iRv == PCRE2_ERROR_NOMATCH)
+        break;
+      if (RX_IS_LIMIT(iRv)) {
+        sPos = rx_utf_next(&rxMatcher, ptJob->pcBuf, sSubj, rxMatcher.sLimitPos);
+        continue;
+      }
+      if (iRv <= 0) {
+        pthread_mutex_lock(&ptJob->tLock);
+        if (ptJob->iMatchErr == 0) ptJob->iMatchErr = (iRv < 0) ? iRv : PCRE2_ERROR_NOMEMORY;
+        pthread_mutex_unlock(&ptJob->tLock);
+        break;
+      }
+      if (psOvector[O_START(0)] >= sStop)
+        break;
+
+      tHit.sStart = psOvector[O_START(0)];
+      tHit.sEnd   = psOvector[O_END(0)];
+      tHit.sFrom  = sFrom;
+      daAdd(t_rx_hit, ptJob->adaHits[sRange], tHit);
+
+      // Go on after match. If the match was an empty string, hop along one pos.
+      sPos = tHit.sEnd;
+      if (tHit.sEnd == tHit.sStart) sPos = rx_utf_next(&rxMatcher, ptJob->pcBuf, ptJob->sLen, sPos);
+      sFrom = sPos;
+    }
+  }
+
+  rxFreeMatcher(&rxMatcher);
+
+  return NULL;
+}
+
+
+//******************************************************************************
+//* public functions
+
+/*******************************************************************************
+ * Name: rxInitPattern
+ *******************************************************************************/
+int rxInitPattern(t_rx_pattern* prxPattern, const char* pcRegex, const char* pcFlags, cstr* pcsErr) {
+  return rxInitPatternCached(prxPattern, pcRegex, pcFlags, NULL, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxInitPatternCached
+ * Purpose: Compiles a pattern once. JIT code is made for complete and partial
+ *          matching here, so the pattern stays read-only afterwards. With a
+ *          cache directory the compiled pattern is loaded from or stored
+ *          there. NULL means no cache.
+ *******************************************************************************/
+int rxInitPatternCached(t_rx_pattern* prxPattern, const char* pcRegex, const char* pcFlags, const char* pcCacheDir, cstr* pcsErr) {
+  cstr csFlags = csNew(pcFlags);
+  cstr csRegex = csNew(pcRegex);
+  int  iErr    = RX_NO_ERROR;
+  int  fJit    = 1;
+
+  prxPattern->pRegex       = NULL;
+  prxPattern->ui32Opts     = 0;
+  prxPattern->pcRegex      = NULL;
+  prxPattern->pcCacheDir   = NULL;
+  prxPattern->fJitWanted   = 0;
+  prxPattern->fOffOnly     = 0;
+  prxPattern->sPrefixLen   = 0;
+  prxPattern->fJit         = 0;
+  prxPattern->fJitPartial  = 0;
+  prxPattern->fDfa         = 0;
+  prxPattern->ui32DfaOpts  = 0;
+  prxPattern->prxNames     = NULL;
+  prxPattern->ui32NameMask = 0;
+
+  // Convert option string into options and init everything to work global.
+  // Because PCRE2_EXTENDED don't work, I use the implicit form '(?x:...)'.
+  for (int i = 0; i < csFlags.len; ++i) {
+    if (csFlags.cStr[i] == 'x') {
+      csSetf(&csRegex, "(?x:%s)", csRegex.cStr);
+      continue;
+    }
+    if (csFlags.cStr[i] == 'i') {
+      prxPattern->ui32Opts |= PCRE2_CASELESS;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'm') {
+      prxPattern->ui32Opts |= PCRE2_MULTILINE;
+      continue;
+    }
+    if (csFlags.cStr[i] == 's') {
+      prxPattern->ui32Opts |= PCRE2_DOTALL;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'u') {
+      prxPattern->ui32Opts |= PCRE2_UTF | PCRE2_UCP;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'J') {
+      fJit = 0;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'o') {
+      prxPattern->fOffOnly = 1;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'D') {
+      prxPattern->fDfa = 1;
+      continue;
+    }
+    if (csFlags.cStr[i] == 'S') {
+      prxPattern->fDfa         = 1;
+      prxPattern->ui32DfaOpts |= PCRE2_DFA_SHORTEST;
+      continue;
+    }
+    if(pcsErr != NULL) csSetf(pcsErr, "Unkown option '%c'", csFlags.cStr[i]);
+    iErr = RX_ERROR;
+    goto free_and_exit;
+  }
+
+  prxPattern->pcRegex    = strdup(csRegex.cStr);
+  prxPattern->pcCacheDir = (pcCacheDir != NULL) ? strdup(pcCacheDir) : NULL;
+  prxPattern->fJitWanted = fJit;
+
+  iErr = rx_compile(prxPattern, pcsErr);
+
+free_and_exit:
+  csFree(&csFlags);
+  csFree(&csRegex);
+
+  return iErr;
+}
+
+/*******************************************************************************
+ * Name: rxFreePattern
+ *******************************************************************************/
+void rxFreePattern(t_rx_pattern* prxPattern) {
+  pcre2_code_free(prxPattern->pRegex);
+  free(prxPattern->prxNames);
+  free(prxPattern->pcRegex);
+  free(prxPattern->pcCacheDir);
+  prxPattern->pRegex     = NULL;
+  prxPattern->prxNames   = NULL;
+  prxPattern->pcRegex    = NULL;
+  prxPattern->pcCacheDir = NULL;
+}
+
+/*******************************************************************************
+ * Name: rxPatternGroupIndex
+ * Purpose: Returns the number of a named group or -1, if there is none.
+ *******************************************************************************/
+int rxPatternGroupIndex(const t_rx_pattern* prxPattern, const char* pcName) {
+  uint32_t ui32Slot = 0;
+
+  if (prxPattern->prxNames == NULL) return -1;
+
+  ui32Slot = rx_name_hash(pcName) & prxPattern->ui32NameMask;
+  while (prxPattern->prxNames[ui32Slot].pcName != NULL) {
+    if (strcmp(prxPattern->prxNames[ui32Slot].pcName, pcName) == 0)
+      return prxPattern->prxNames[ui32Slot].iGroup;
+    ui32Slot = (ui32Slot + 1) & prxPattern->ui32NameMask;
+  }
+
+  return -1;
+}
+
+/*******************************************************************************
+ * Name: rxSetPatternPrefix
+ * Purpose: Sets the literal bytes every match starts with, enabling the
+ *          memchr() prefilter. It must agree with the pattern's first code
+ *          unit, if there is one. sLen 0 turns the prefilter off.
+ *          Contract: Every match of the pattern must begin with these bytes.
+ *          Beyond the first code unit that isn't checked, a wrong prefix just
+ *          loses the matches not beginning with it.
+ *          Two bytes and more anchor pcre2 at each candidate by an offset
+ *          limit. The pattern is compiled once more allowing that then.
+ *******************************************************************************/
+int rxSetPatternPrefix(t_rx_pattern* prxPattern, const char* pcPrefix, size_t sLen, cstr* pcsErr) {
+  if (sLen > RX_PREFIX_MAX) {
+    if (pcsErr != NULL) csSetf(pcsErr, "Prefix longer than %d bytes", RX_PREFIX_MAX);
+    return RX_ERROR;
+  }
+  if (sLen > 0 && prxPattern->sPrefixLen > 0 && pcPrefix[0] != prxPattern->acPrefix[0]) {
+    if (pcsErr != NULL) csSet(pcsErr, "Prefix doesn't fit the regex's first code unit");
+    return RX_ERROR;
+  }
+
+  memcpy(prxPattern->acPrefix, pcPrefix, sLen);
+  prxPattern->sPrefixLen = sLen;
+
+  if (sLen < 2 || (prxPattern->ui32Opts & PCRE2_USE_OFFSET_LIMIT))
+    return RX_NO_ERROR;
+
+  pcre2_code_free(prxPattern->pRegex);
+  free(prxPattern->prxNames);
+  prxPattern->pRegex    = NULL;
+  prxPattern->prxNames  = NULL;
+  prxPattern->ui32Opts |= PCRE2_USE_OFFSET_LIMIT;
+
+  return rx_compile(prxPattern, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxInitMatcherShared
+ * Purpose: Creates the match state for a compiled pattern without compiling.
+ *          The pattern is not owned and must outlive the matcher.
+ *******************************************************************************/
+int rxInitMatcherShared(t_rx_matcher* prxMatcher, const t_rx_pattern* prxPattern) {
+  prxMatcher->prxPattern  = prxPattern;
+  prxMatcher->sPos        = 0;
+  prxMatcher->pcSubject   = NULL;
+  prxMatcher->sSubjectLen = 0;
+  prxMatcher->pJitStack   = NULL;
+  prxMatcher->piDfaWork   = NULL;
+  prxMatcher->sDfaWork    = 0;
+  prxMatcher->fStats      = 0;
+  prxMatcher->sHeapUsed   = 0;
+  prxMatcher->sLimitPos   = 0;
+  prxMatcher->pcUtfOk     = NULL;
+  prxMatcher->sUtfOkLen   = 0;
+  memset(&prxMatcher->rxStats, 0, sizeof(t_rx_stats));
+
+  // Init cstr and int arrays, which holds all matches and offsets.
+  daInit(cstr, prxMatcher->dacsMatch);
+  daInit(size_t, prxMatcher->dasStart);
+  daInit(size_t, prxMatcher->dasEnd);
+
+  // Each matcher has its own allocator, context and space for all parentheses,
+  // which are reused for every match. So the matcher must not be moved.
+  prxMatcher->pGenCtx    = pcre2_general_context_create(rx_mem_alloc, rx_mem_free, prxMatcher);
+  prxMatcher->pMatchCtx  = pcre2_match_context_create(prxMatcher->pGenCtx);
+  prxMatcher->pMatchData = pcre2_match_data_create_from_pattern(prxPattern->pRegex, prxMatcher->pGenCtx);
+
+  // JIT stacks can't be shared between threads.
+  if (prxPattern->fJit) {
+    prxMatcher->pJitStack = pcre2_jit_stack_create(RX_JIT_STACK_START, RX_JIT_STACK_MAX, prxMatcher->pGenCtx);
+    pcre2_jit_stack_assign(prxMatcher->pMatchCtx, NULL, prxMatcher->pJitStack);
+  }
+
+  if (prxPattern->fDfa) {
+    prxMatcher->sDfaWork  = RX_DFA_WORKSPACE;
+    prxMatcher->piDfaWork = (int*) malloc(sizeof(int) * prxMatcher->sDfaWork);
+  }
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxInitMatcher
+ *******************************************************************************/
+int rxInitMatcher(t_rx_matcher* prxMatcher, const char* pcRegex, const char* pcFlags, cstr* pcsErr) {
+  return rxInitMatcherCached(prxMatcher, pcRegex, pcFlags, NULL, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxInitMatcherCached
+ * Purpose: Like rxInitMatcher(), but with rxInitPatternCached().
+ *******************************************************************************/
+int rxInitMatcherCached(t_rx_matcher* prxMatcher, const char* pcRegex, const char* pcFlags, const char* pcCacheDir, cstr* pcsErr) {
+  int iErr = rxInitPatternCached(&prxMatcher->rxPattern, pcRegex, pcFlags, pcCacheDir, pcsErr);
+
+  if (iErr != RX_NO_ERROR) {
+    prxMatcher->prxPattern = NULL;
+    return iErr;
+  }
+
+  rxInitMatcherShared(prxMatcher, &prxMatcher->rxPattern);
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxFreeMatcher
+ * Purpose: Frees match state and the pattern, if owned.
+ *******************************************************************************/
+void rxFreeMatcher(t_rx_matcher* prxMatcher) {
+  if (prxMatcher->prxPattern == NULL) return;
+
+  pcre2_match_data_free(prxMatcher->pMatchData);
+  pcre2_match_context_free(prxMatcher->pMatchCtx);
+  pcre2_jit_stack_free(prxMatcher->pJitStack);
+  pcre2_general_context_free(prxMatcher->pGenCtx);
+  free(prxMatcher->piDfaWork);
+  daFreeEx(prxMatcher->dacsMatch, cStr);
+  daFree(prxMatcher->dasStart);
+  daFree(prxMatcher->dasEnd);
+
+  if (prxMatcher->prxPattern == &prxMatcher->rxPattern)
+    rxFreePattern(&prxMatcher->rxPattern);
+  prxMatcher->prxPattern = NULL;
+}
+
+/*******************************************************************************
+ * Name: rxMatch
+ *******************************************************************************/
+int rxMatch(t_rx_matcher* prxMatcher, size_t sStartPos, const char* pcSearchStr, size_t sSearchLenMax, int* piErr, cstr* pcsErr) {
+  size_t      sStrLength  = 0;
+  int         iMatchCount = 0;
+  int         iRv         = RX_RV_CONT;
+  PCRE2_SIZE* psOvector   = NULL;
+
+  // Within a running RX_KEEP_POS loop over the same subject its length is
+  // already known. This keeps the loop linear for long strings.
+  if (sSearchLenMax != RX_LEN_MAX)
+    sStrLength = sSearchLenMax;
+  else if (sStartPos == RX_KEEP_POS && prxMatcher->sPos != 0 && pcSearchStr == prxMatcher->pcSubject)
+    sStrLength = prxMatcher->sSubjectLen;
+  else
+    sStrLength = strlen(pcSearchStr);
+
+  // Init error value to none.
+  if (piErr != NULL) *piErr = RX_NO_ERROR;
+
+  //****************************************************************************
+  //* The actual matching function block.
+  //****************************************************************************
+
+  // Remember subject for rxGetMatch() and the next loop iteration.
+  prxMatcher->pcSubject   = pcSearchStr;
+  prxMatcher->sSubjectLen = sStrLength;
+
+  // Set pos to start from if wanted. From 0 the subject is a new one.
+  if (sStartPos != RX_KEEP_POS)
+    prxMatcher->sPos = sStartPos;
+  if (prxMatcher->sPos == 0)
+    prxMatcher->pcUtfOk = NULL;
+
+  iMatchCount = rx_find(prxMatcher, pcSearchStr, sStrLength, prxMatcher->sPos, 0);
+
+  // Offsets of a previous match don't belong to this subject. A failed match
+  // leaves none, so rxGetMatch() returns empty strings then.
+  daReset(prxMatcher->dasStart);
+  daReset(prxMatcher->dasEnd);
+
+  //****************************************************************************
+  //* Error handling.
+  //****************************************************************************
+
+  if (iMatchCount == PCRE2_ERROR_NOMATCH) {   // Just no match, no error!
+    if (pcsErr != NULL) csSet(pcsErr, "No match");
+    if (piErr  != NULL) *piErr = RX_NO_MATCH;
+    iRv    = RX_RV_END;
+    prxMatcher->sPos = 0;
+    goto free_and_exit;
+  }
+  if (RX_IS_LIMIT(iMatchCount)) {             // Skip candidate on next call.
+    if (pcsErr != NULL) csSetf(pcsErr, "Limit hit %d at %zu", iMatchCount, prxMatcher->sLimitPos);
+    if (piErr  != NULL) *piErr = RX_LIMIT;
+    iRv    = RX_RV_END;
+    prxMatcher->sPos = rx_utf_next(prxMatcher, pcSearchStr, sStrLength, prxMatcher->sLimitPos);
+    goto free_and_exit;
+  }
+  if (iMatchCount < 0) {                      // Matching failed.
+    if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iMatchCount);
+    if (piErr  != NULL) *piErr = RX_ERROR;
+    iRv    = RX_RV_END;
+    goto free_and_exit;
+  }
+  if (iMatchCount == 0) {                     // Creating output vector failed.
+    if (pcsErr != NULL) csSet(pcsErr, "'ovector' was not big enough for all captured substrings");
+    if (piErr  != NULL) *piErr = RX_NO_VECTOR;
+    iRv    = RX_RV_END;
+    goto free_and_exit;
+  }
+
+  //****************************************************************************
+  //* Match succeded. Get a pointer to the output vector, where string offsets
+  //* are stored. Copy all offsets and, if wanted, all matches into the dynamic
+  //* arrays, reusing their memory.
+  //****************************************************************************
+
+  psOvector = pcre2_get_ovector_pointer(prxMatcher->pMatchData);
+
+  for (int i = 0; i < iMatchCount; ++i) {
+    daAdd(size_t, prxMatcher->dasStart, psOvector[O_START(i)]);
+    daAdd(size_t, prxMatcher->dasEnd,   psOvector[O_END(i)]);
+  }
+
+  // Free surplus strings of a previous match with more submatches.
+  if (prxMatcher->prxPattern->fOffOnly) iMatchCount = 0;
+  while (prxMatcher->dacsMatch.sCount > iMatchCount)
+    csFree(&prxMatcher->dacsMatch.pVal[--prxMatcher->dacsMatch.sCount]);
+
+  for (int i = 0; i < iMatchCount; ++i) {
+    if (i == prxMatcher->dacsMatch.sCount)
+      daAdd(cstr, prxMatcher->dacsMatch, csNew(""));
+    rxGetMatch(prxMatcher, i, &prxMatcher->dacsMatch.pVal[i]);
+  }
+
+  // Store end of complete match as pos().
+  prxMatcher->sPos = psOvector[O_END(0)];
+
+  // If the match was an empty string, hop along one pos.
+  if (psOvector[O_END(0)] == psOvector[O_START(0)]) {
+    if (pcsErr != NULL) csSet(pcsErr, "Empty string");
+    if (piErr  != NULL) *piErr = RX_NO_ERROR;
+    iRv    = RX_RV_CONT;
+    prxMatcher->sPos = rx_utf_next(prxMatcher, pcSearchStr, sStrLength, prxMatcher->sPos);
+    goto free_and_exit;
+  }
+
+  if (psOvector[0] >= sStrLength) {
+    if (pcsErr != NULL) csSet(pcsErr, "End of subject");
+    if (piErr  != NULL) *piErr = RX_NO_ERROR;
+    iRv    = RX_RV_END;
+    prxMatcher->sPos = 0;
+    goto free_and_exit;
+  }
+
+free_and_exit:
+  return iRv;
+}
+
+/*******************************************************************************
+ * Name: rxGetMatch
+ * Purpose: Copies submatch iNum of last successful match into pcsMatch.
+ *          Returns 0 and an empty string, if submatch is not set.
+ *******************************************************************************/
+int rxGetMatch(t_rx_matcher* prxMatcher, int iNum, cstr* pcsMatch) {
+  size_t sStart = 0;
+  size_t sEnd   = 0;
+
+  if (iNum < 0 || iNum >= prxMatcher->dasStart.sCount ||
+      prxMatcher->dasStart.pVal[iNum] == PCRE2_UNSET) {
+    csSetMem(pcsMatch, "", 0);
+    return 0;
+  }
+
+  sStart = prxMatcher->dasStart.pVal[iNum];
+  sEnd   = prxMatcher->dasEnd.pVal[iNum];
+  csSetMem(pcsMatch, prxMatcher->pcSubject + sStart, sEnd - sStart);
+
+  return 1;
+}
+
+/*******************************************************************************
+ * Name: rxReplace
+ * Purpose: Replaces the first match. Returns number of replacements (0 or 1).
+ *******************************************************************************/
+int rxReplace(t_rx_matcher* prxMatcher, const char* pcSubject, size_t sLen, const char* pcReplace, cstr* pcsOut, int* piErr, cstr* pcsErr) {
+  return rx_substitute(prxMatcher, pcSubject, sLen, pcReplace, 0, pcsOut, piErr, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxReplaceAll
+ * Purpose: Replaces all matches. Returns number of replacements.
+ *******************************************************************************/
+int rxReplaceAll(t_rx_matcher* prxMatcher, const char* pcSubject, size_t sLen, const char* pcReplace, cstr* pcsOut, int* piErr, cstr* pcsErr) {
+  return rx_substitute(prxMatcher, pcSubject, sLen, pcReplace, PCRE2_SUBSTITUTE_GLOBAL, pcsOut, piErr, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxSplit
+ * Purpose: Splits a buffer at all matches in one pass. An empty match never
+ *          splits at the buffer's start or end, nor where the last match
+ *          ended, like in Perl.
+ *******************************************************************************/
+int rxSplit(t_rx_matcher* prxMatcher, const char* pcBuf, size_t sLen, int iLimit, int fCaptures, t_array(t_rx_span)* pdaFields, cstr* pcsErr) {
+  const PCRE2_SIZE* psOvector   = pcre2_get_ovector_pointer(prxMatcher->pMatchData);
+  t_rx_span         tSpan       = {0};
+  size_t            sField      = 0;    // Start of current field.
+  size_t            sPos        = 0;
+  uint32_t          uiGroups    = pcre2_get_ovector_count(prxMatcher->pMatchData);
+  int               iFields     = 1;
+  int               iMatchCount = 0;
+
+  if (sLen == RX_LEN_MAX) sLen = strlen(pcBuf);
+
+  daReset((*pdaFields));
+  prxMatcher->pcUtfOk = NULL;
+
+  while (sPos <= sLen && (iLimit <= 0 || iFields < iLimit)) {
+    // No empty match at a field's start.
+    iMatchCount = rx_find(prxMatcher, pcBuf, sLen, sPos, (sPos == sField) ? PCRE2_NOTEMPTY_ATSTART : 0);
+
+    if (iMatchCount == PCRE2_ERROR_NOMATCH)
+      break;
+    if (RX_IS_LIMIT(iMatchCount)) {
+      sPos = rx_utf_next(prxMatcher, pcBuf, sLen, prxMatcher->sLimitPos);
+      continue;
+    }
+    if (iMatchCount < 0) {
+      if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iMatchCount);
+      return RX_ERROR;
+    }
+    if (iMatchCount == 0) {
+      if (pcsErr != NULL) csSet(pcsErr, "'ovector' was not big enough for all captured substrings");
+      return RX_NO_VECTOR;
+    }
+
+    // Nor at the end.
+    if (psOvector[O_END(0)] == psOvector[O_START(0)] && psOvector[O_START(0)] >= sLen)
+      break;
+
+    tSpan.sStart = sField;
+    tSpan.sEnd   = psOvector[O_START(0)];
+    daAdd(t_rx_span, (*pdaFields), tSpan);
+    ++iFields;
+
+    // All groups like in Perl, unset ones at the end, too.
+    for (uint32_t i = 1; fCaptures && i < uiGroups; ++i) {
+      tSpan.sStart = psOvector[O_START(i)];
+      tSpan.sEnd   = psOvector[O_END(i)];
+      daAdd(t_rx_span, (*pdaFields), tSpan);
+    }
+
+    sField = psOvector[O_END(0)];
+    sPos   = sField;
+  }
+
+  // Rest is the last field.
+  tSpan.sStart = sField;
+  tSpan.sEnd   = sLen;
+  daAdd(t_rx_span, (*pdaFields), tSpan);
+
+  // Drop trailing empty fields.
+  while (iLimit == 0 && pdaFields->sCount > 0 &&
+         pdaFields->pVal[pdaFields->sCount - 1].sStart == pdaFields->pVal[pdaFields->sCount - 1].sEnd)
+    --pdaFields->sCount;
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxForEach
+ * Purpose: Runs global matching over a buffer and calls back on each match
+ *          with the ovector. Matcher's match data is reused, nothing is
+ *          allocated per match. Callback returns RX_RV_END to stop early.
+ *******************************************************************************/
+int rxForEach(t_rx_matcher* prxMatcher, const char* pcBuf, size_t sLen, t_rx_callback fCallback, void* pvUser, cstr* pcsErr) {
+  const PCRE2_SIZE* psOvector   = pcre2_get_ovector_pointer(prxMatcher->pMatchData);
+  size_t            sPos        = 0;
+  int               iMatchCount = 0;
+
+  if (sLen == RX_LEN_MAX) sLen = strlen(pcBuf);
+
+  prxMatcher->pcUtfOk = NULL;
+
+  while (sPos <= sLen) {
+    iMatchCount = rx_find(prxMatcher, pcBuf, sLen, sPos, 0);
+
+    if (iMatchCount == PCRE2_ERROR_NOMATCH)
+      break;
+    if (RX_IS_LIMIT(iMatchCount)) {
+      sPos = rx_utf_next(prxMatcher, pcBuf, sLen, prxMatcher->sLimitPos);
+      continue;
+    }
+    if (iMatchCount < 0) {
+      if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iMatchCount);
+      return RX_ERROR;
+    }
+    if (iMatchCount == 0) {
+      if (pcsErr != NULL) csSet(pcsErr, "'ovector' was not big enough for all captured substrings");
+      return RX_NO_VECTOR;
+    }
+
+    if (fCallback(psOvector, iMatchCount, pvUser) == RX_RV_END)
+      break;
+
+    // Go on after match. If the match was an empty string, hop along one pos.
+    sPos = psOvector[O_END(0)];
+    if (psOvector[O_END(0)] == psOvector[O_START(0)]) sPos = rx_utf_next(prxMatcher, pcBuf, sLen, sPos);
+  }
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxGroupIndex
+ * Purpose: rxPatternGroupIndex() of the matcher's pattern.
+ *******************************************************************************/
+int rxGroupIndex(const t_rx_matcher* prxMatcher, const char* pcName) {
+  return rxPatternGroupIndex(prxMatcher->prxPattern, pcName);
+}
+
+/*******************************************************************************
+ * Name: rxSetPrefix
+ * Purpose: rxSetPatternPrefix() for a matcher owning its pattern.
+ *******************************************************************************/
+int rxSetPrefix(t_rx_matcher* prxMatcher, const char* pcPrefix, size_t sLen, cstr* pcsErr) {
+  if (prxMatcher->prxPattern != &prxMatcher->rxPattern) {
+    if (pcsErr != NULL) csSet(pcsErr, "Matcher shares its pattern, set the prefix there");
+    return RX_ERROR;
+  }
+
+  return rxSetPatternPrefix(&prxMatcher->rxPattern, pcPrefix, sLen, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxInitSet
+ * Purpose: Compiles iCount patterns into one branch reset alternation, where
+ *          each branch is marked with its index. Flag 'x' is an error, its
+ *          comments would run into the following mark and branches.
+ *******************************************************************************/
+int rxInitSet(t_rx_set* prxSet, const char** apcRegex, int iCount, const char* pcFlags, cstr* pcsErr) {
+  cstr csRegex  = csNew("(?|");
+  cstr csBranch = csNew("");
+  int  iErr     = RX_NO_ERROR;
+
+  if (pcFlags != NULL && strchr(pcFlags, 'x') != NULL) {
+    if(pcsErr != NULL) csSet(pcsErr, "Option 'x' isn't allowed for pattern sets");
+    iErr = RX_ERROR;
+    goto free_and_exit;
+  }
+
+  for (int i = 0; i < iCount; ++i) {
+    csSetf(&csBranch, "%s(?:%s)(*MARK:%d)", (i > 0) ? "|" : "", apcRegex[i], i);
+    csAddStr(&csRegex, csBranch.cStr);
+  }
+  csAddStr(&csRegex, ")");
+
+  prxSet->iCount = iCount;
+  iErr = rxInitMatcher(&prxSet->rxMatcher, csRegex.cStr, pcFlags, pcsErr);
+
+free_and_exit:
+  csFree(&csRegex);
+  csFree(&csBranch);
+
+  return iErr;
+}
+
+/*******************************************************************************
+ * Name: rxFreeSet
+ *******************************************************************************/
+void rxFreeSet(t_rx_set* prxSet) {
+  rxFreeMatcher(&prxSet->rxMatcher);
+}
+
+/*******************************************************************************
+ * Name: rxSetForEach
+ * Purpose: Like rxForEach(), but reports the index of the matching pattern.
+ *          All patterns are found in offset order in a single pass.
+ *******************************************************************************/
+int rxSetForEach(t_rx_set* prxSet, const char* pcBuf, size_t sLen, t_rx_set_callback fCallback, void* pvUser, cstr* pcsErr) {
+  t_rx_set_relay tRelay = {prxSet, fCallback, pvUser};
+  return rxForEach(&prxSet->rxMatcher, pcBuf, sLen, rx_set_relay, &tRelay, pcsErr);
+}
+
+/*******************************************************************************
+ * Name: rxInitStream
+ * Purpose: Inits streaming over a matcher.
+ *******************************************************************************/
+int rxInitStream(t_rx_stream* prxStream, t_rx_matcher* prxMatcher, size_t sRightCtx) {
+  uint32_t ui32LookBehind = 0;
+
+  pcre2_pattern_info(prxMatcher->prxPattern->pRegex, PCRE2_INFO_MAXLOOKBEHIND, &ui32LookBehind);
+
+  prxStream->prxMatcher  = prxMatcher;
+  prxStream->pcBuf       = NULL;
+  prxStream->sLen        = 0;
+  prxStream->sCapacity   = 0;
+  prxStream->sBase       = 0;
+  prxStream->sPos        = 0;
+  prxStream->sLookBehind = ui32LookBehind;
+  prxStream->sRightCtx   = sRightCtx;
+  prxStream->fDone       = 0;
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxFreeStream
+ *******************************************************************************/
+void rxFreeStream(t_rx_stream* prxStream) {
+  free(prxStream->pcBuf);
+  prxStream->pcBuf     = NULL;
+  prxStream->sCapacity = 0;
+}
+
+/*******************************************************************************
+ * Name: rxStreamSpace
+ * Purpose: Returns room for sLen bytes behind the retained tail. Feeding this
+ *          pointer to rxStreamFeed() avoids copying the chunk.
+ *******************************************************************************/
+char* rxStreamSpace(t_rx_stream* prxStream, size_t sLen) {
+  if (prxStream->sLen + sLen > prxStream->sCapacity) {
+    prxStream->sCapacity = prxStream->sLen + sLen;
+    prxStream->pcBuf     = (char*) realloc(prxStream->pcBuf, prxStream->sCapacity);
+  }
+  return prxStream->pcBuf + prxStream->sLen;
+}
+
+/*******************************************************************************
+ * Name: rxStreamFeed
+ * Purpose: Appends a chunk and reports all matches, which can't change with
+ *          further data. A partial match at the end is kept for the next
+ *          chunk. With fFinal everything left is matched to the end.
+ *******************************************************************************/
+int rxStreamFeed(t_rx_stream* prxStream, const char* pcChunk, size_t sLen, int fFinal, t_rx_stream_callback fCallback, void* pvUser, cstr* pcsErr) {
+  t_rx_matcher*     prxM        = prxStream->prxMatcher;
+  const PCRE2_SIZE* psOvector   = pcre2_get_ovector_pointer(prxM->pMatchData);
+  uint32_t          ui32Opts    = 0;
+  size_t            sKeep       = 0;
+  size_t            sSubj       = 0;
+  int               iMatchCount = 0;
+
+  if (prxStream->fDone) return RX_NO_ERROR;
+  if (fFinal) prxStream->fDone = 1;
+
+  // Append chunk, if it's not already in place.
+  if (sLen > 0) {
+    if (pcChunk != prxStream->pcBuf + prxStream->sLen)
+      memcpy(rxStreamSpace(prxStream, sLen), pcChunk, sLen);
+    prxStream->sLen += sLen;
+  }
+
+  // Not at the start of data anymore, '^' must not match at buffer start.
+  if (! fFinal)          ui32Opts |= PCRE2_PARTIAL_HARD;
+  if (prxStream->sBase)  ui32Opts |= PCRE2_NOTBOL;
+
+  // Buffer's bytes moved, validate them once more. A character cut off at the
+  // end waits for the next chunk.
+  prxM->pcUtfOk = NULL;
+  sSubj         = fFinal ? prxStream->sLen : rx_utf_trim(prxM, prxStream->pcBuf, prxStream->sLen);
+
+  while (prxStream->sPos <= sSubj) {
+    iMatchCount = rx_find(prxM, prxStream->pcBuf, sSubj, prxStream->sPos, ui32Opts);
+
+    // Nothing more in here.
+    if (iMatchCount == PCRE2_ERROR_NOMATCH) {
+      prxStream->sPos = sSubj;
+      break;
+    }
+    // Needs more data, resume at partial match's start.
+    if (iMatchCount == PCRE2_ERROR_PARTIAL) {
+      prxStream->sPos = psOvector[O_START(0)];
+      break;
+    }
+    if (RX_IS_LIMIT(iMatchCount)) {
+      prxStream->sPos = rx_utf_next(prxM, prxStream->pcBuf, sSubj, prxM->sLimitPos);
+      continue;
+    }
+    if (iMatchCount < 0) {
+      if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iMatchCount);
+      return RX_ERROR;
+    }
+    if (iMatchCount == 0) {
+      if (pcsErr != NULL) csSet(pcsErr, "'ovector' was not big enough for all captured substrings");
+      return RX_NO_VECTOR;
+    }
+    // Complete, but too close to the end for the callback's look ahead.
+    if (! fFinal && psOvector[O_END(0)] + prxStream->sRightCtx > prxStream->sLen) {
+      prxStream->sPos = psOvector[O_START(0)];
+      break;
+    }
+
+    if (fCallback(prxStream, psOvector, iMatchCount, pvUser) == RX_RV_END) {
+      prxStream->fDone = 1;
+      break;
+    }
+
+    // Go on after match. If the match was an empty string, hop along one pos.
+    prxStream->sPos = psOvector[O_END(0)];
+    if (psOvector[O_END(0)] == psOvector[O_START(0)])
+      prxStream->sPos = rx_utf_next(prxM, prxStream->pcBuf, sSubj, prxStream->sPos);
+  }
+
+  // Drop all bytes, which are done, but keep lookbehind.
+  sKeep = (prxStream->sPos > prxStream->sLookBehind) ? prxStream->sPos - prxStream->sLookBehind : 0;
+  if (sKeep > prxStream->sLen) sKeep = prxStream->sLen;
+  memmove(prxStream->pcBuf, prxStream->pcBuf + sKeep, prxStream->sLen - sKeep);
+  prxStream->sLen  -= sKeep;
+  prxStream->sPos  -= sKeep;
+  prxStream->sBase += sKeep;
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name: rxSetLimits
+ * Purpose: Sets match, depth and heap (KiB) limits of the matcher's context.
+ *          0 keeps a limit as it is.
+ *******************************************************************************/
+void rxSetLimits(t_rx_matcher* prxMatcher, uint32_t ui32Match, uint32_t ui32Depth, uint32_t ui32HeapKiB) {
+  if (ui32Match   > 0) pcre2_set_match_limit(prxMatcher->pMatchCtx, ui32Match);
+  if (ui32Depth   > 0) pcre2_set_depth_limit(prxMatcher->pMatchCtx, ui32Depth);
+  if (ui32HeapKiB > 0) pcre2_set_heap_limit(prxMatcher->pMatchCtx, ui32HeapKiB);
+}
+
+/*******************************************************************************
+ * Name: rxEnableStats
+ * Purpose: Turns counting on or off and resets all counters.
+ *******************************************************************************/
+void rxEnableStats(t_rx_matcher* prxMatcher, int fOn) {
+  prxMatcher->fStats = fOn;
+  memset(&prxMatcher->rxStats, 0, sizeof(t_rx_stats));
+  prxMatcher->rxStats.ui64HeapPeak = prxMatcher->sHeapUsed;
+}
+
+/*******************************************************************************
+ * Name: rxGetStats
+ *******************************************************************************/
+void rxGetStats(const t_rx_matcher* prxMatcher, t_rx_stats* prxStats) {
+  *prxStats = prxMatcher->rxStats;
+}
+
+/*******************************************************************************
+ * Name: rxAddStats
+ * Purpose: Adds the counters of prxFrom, i.e. of another thread's matcher of
+ *          the same pattern. The heap peak is the highest of both.
+ *******************************************************************************/
+void rxAddStats(t_rx_matcher* prxMatcher, const t_rx_matcher* prxFrom) {
+  t_rx_stats*       prxS = &prxMatcher->rxStats;
+  const t_rx_stats* prxF = &prxFrom->rxStats;
+
+  prxS->ui64Calls     += prxF->ui64Calls;
+  prxS->ui64Matches   += prxF->ui64Matches;
+  prxS->ui64NoMatches += prxF->ui64NoMatches;
+  prxS->ui64Bytes     += prxF->ui64Bytes;
+  prxS->ui64Empty     += prxF->ui64Empty;
+  prxS->ui64LimitHits += prxF->ui64LimitHits;
+  prxS->ui64Nsec      += prxF->ui64Nsec;
+  if (prxF->ui64HeapPeak > prxS->ui64HeapPeak) prxS->ui64HeapPeak = prxF->ui64HeapPeak;
+}
+
+/*******************************************************************************
+ * Name: rxPrintStats
+ * Purpose: Prints all counters of a matcher in one line.
+ *******************************************************************************/
+void rxPrintStats(const t_rx_matcher* prxMatcher, const char* pcName, FILE* hOut) {
+  const t_rx_stats* prxS = &prxMatcher->rxStats;
+  double            dSec = prxS->ui64Nsec / 1e9;
+
+  fprintf(hOut, "%-12s calls %10llu  matches %10llu  no matches %10llu  empty %8llu  "
+                "limit hits %6llu  bytes %14llu  time %10.6f s  %9.1f MiB/s  heap peak %llu\n",
+          pcName,
+          (unsigned long long) prxS->ui64Calls,
+          (unsigned long long) prxS->ui64Matches,
+          (unsigned long long) prxS->ui64NoMatches,
+          (unsigned long long) prxS->ui64Empty,
+          (unsigned long long) prxS->ui64LimitHits,
+          (unsigned long long) prxS->ui64Bytes,
+          dSec,
+          (dSec > 0) ? prxS->ui64Bytes / dSec / (1024.0 * 1024.0) : 0.0,
+          (unsigned long long) prxS->ui64HeapPeak);
+}
+
+/*******************************************************************************
+ * Name: rxParallelScan
+ * Purpose: Scans a buffer's ranges in iThreads threads and merges all hits in
+ *          offset order into pdaHits. A range's hits count only, if its search
+ *          began where the previous hit ends. Where a match across a range
+ *          border breaks that chain, it is matched serially again until a
+ *          match is a worker's hit or none is left, which leaves the result
+ *          equal to rxForEach().
+ *******************************************************************************/
+int rxParallelScan(const t_rx_pattern* prxPattern, const char* pcBuf, size_t sLen, int iThreads, size_t sOverlap, t_array(t_rx_hit)* pdaHits, cstr* pcsErr) {
+  t_rx_par_job      tJob      = {0};
+  t_array(t_rx_hit) daAll;
+  pthread_t*        atThread  = NULL;
+  t_rx_matcher      rxMatcher = {0};
+  const PCRE2_SIZE* psOvector = NULL;
+  t_rx_hit          tHit      = {0};
+  size_t            sResume   = 0;
+  size_t            i         = 0;
+  int               iRv       = 0;
+  int               iErr      = RX_NO_ERROR;
+  int               fResync   = 0;
+  int               fMerged   = 0;
+
+  if (sLen == RX_LEN_MAX) sLen = strlen(pcBuf);
+  if (iThreads <= 0)      iThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (iThreads <= 0)      iThreads = 1;
+
+  // Cut ranges, not too small for the thread overhead.
+  tJob.prxPattern = prxPattern;
+  tJob.pcBuf      = pcBuf;
+  tJob.sLen       = sLen;
+  tJob.sOverlap   = sOverlap;
+  tJob.fUtfOk     = (prxPattern->ui32Opts & PCRE2_UTF) && rx_utf_valid(pcBuf, sLen);
+  tJob.sRange     = (sLen + iThreads * RX_PAR_RANGES_PER_THREAD - 1) / (iThreads * RX_PAR_RANGES_PER_THREAD);
+  if (tJob.sRange < RX_PAR_RANGE_MIN) tJob.sRange = RX_PAR_RANGE_MIN;
+  tJob.sRanges    = (sLen + tJob.sRange - 1) / tJob.sRange;
+  if (tJob.sRanges == 0) tJob.sRanges = 1;
+  if ((size_t) iThreads > tJob.sRanges) iThreads = (int) tJob.sRanges;
+  pthread_mutex_init(&tJob.tLock, NULL);
+
+  tJob.adaHits = (t_array(t_rx_hit)*) malloc(sizeof(t_array(t_rx_hit)) * tJob.sRanges);
+  for (i = 0; i < tJob.sRanges; ++i)
+    daInit(t_rx_hit, tJob.adaHits[i]);
+
+  // This thread is a worker, too.
+  atThread = (pthread_t*) malloc(sizeof(pthread_t) * iThreads);
+  for (int t = 1; t < iThreads; ++t)
+    pthread_create(&atThread[t], NULL, rx_par_worker, &tJob);
+  rx_par_worker(&tJob);
+  for (int t = 1; t < iThreads; ++t)
+    pthread_join(atThread[t], NULL);
+
+  if (tJob.iMatchErr != 0) {
+    if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", tJob.iMatchErr);
+    iErr = RX_ERROR;
+    goto free_and_exit;
+  }
+
+  daInit(t_rx_hit, daAll);
+  hpMerge(t_rx_hit, tJob.adaHits, tJob.sRanges, daAll, rx_cmp_hit, fMerged);
+  if (! fMerged) {
+    if (pcsErr != NULL) csSet(pcsErr, "Out of memory merging hits");
+    iErr = RX_ERROR;
+    daFree(daAll);
+    goto free_and_exit;
+  }
+
+  // Keep the chain of hits a serial scan would find. Close gaps serially.
+  rxInitMatcherShared(&rxMatcher, prxPattern);
+  psOvector = pcre2_get_ovector_pointer(rxMatcher.pMatchData);
+  daReset((*pdaHits));
+  if (tJob.fUtfOk) {
+    rxMatcher.pcUtfOk   = pcBuf;
+    rxMatcher.sUtfOkLen = sLen;
+  }
+
+  // A skipped hit's range has lost the serial chain. Until a serial match is a
+  // worker's hit again, its further hits prove nothing, even beyond the last.
+  i = 0;
+  for (;;) {
+    if (i < daAll.sCount && daAll.pVal[i].sStart < sResume) {
+      fResync = 1;
+      ++i;
+      continue;
+    }
+    if (i == daAll.sCount && ! fResync)
+      break;
+
+    if (i < daAll.sCount && daAll.pVal[i].sFrom <= sResume) {
+      tHit    = daAll.pVal[i++];
+      fResync = 0;
+    }
+    else {
+      iRv = rx_find(&rxMatcher, pcBuf, sLen, sResume, 0);
+      if (iRv == PCRE2_ERROR_NOMATCH)
+        break;
+      if (RX_IS_LIMIT(iRv)) {
+        sResume = rx_utf_next(&rxMatcher, pcBuf, sLen, rxMatcher.sLimitPos);
+        continue;
+      }
+      if (iRv <= 0) {
+        if (pcsErr != NULL) csSetf(pcsErr, "Matching error %d", iRv);
+        iErr = RX_ERROR;
+        break;
+      }
+      tHit.sStart = psOvector[O_START(0)];
+      tHit.sEnd   = psOvector[O_END(0)];
+      tHit.sFrom  = sResume;
+      while (i < daAll.sCount && daAll.pVal[i].sStart < tHit.sStart) ++i;
+      if (i < daAll.sCount && daAll.pVal[i].sStart == tHit.sStart) {
+        fResync = 0;
+        ++i;
+      }
+    }
+
+    daAdd(t_rx_hit, (*pdaHits), tHit);
+    sResume = tHit.sEnd;
+    if (tHit.sEnd == tHit.sStart) sResume = rx_utf_next(&rxMatcher, pcBuf, sLen, sResume);
+  }
+
+  rxFreeMatcher(&rxMatcher);
+  daFree(daAll);
+
+free_and_exit:
+  for (i = 0; i < tJob.sRanges; ++i)
+    daFree(tJob.adaHits[i]);
+  free(tJob.adaHits);
+  free(atThread);
+  pthread_mutex_destroy(&tJob.tLock);
+
+  return iErr;
+}
+
 
 #endif // C_MY_REGEX_H
@@ -2,7 +2,7 @@
  ** Name: c_string.h
  ** Purpose:  Provides a self contained kind of string.
  ** Author: (JE) Jens Elstner
- ** Version: v0.24.2
+ ** Version: v0.25.0
  *******************************************************************************
  ** Date        User  Log
  **-----------------------------------------------------------------------------
@@ -91,6 +91,8 @@
  ** 08.09.2025  JE    Switched if-else logic in 'csIconv()'.
  ** 24.11.2025  JE    Added exponent handling in 'cstrtoll()'.
  ** 25.11.2025  JE    Now 'cstr2ll()' and 'csHex2ll()' just use 'strtold()'.
+ ** 19.10.2026  JE    Added 'csReserve()' and 'csSetMem()' setting binary bytes
+ **                   including '\0', both reuse the cstr's memory.
  *******************************************************************************/
 
 
@@ -177,6 +179,8 @@ void        csSetf(cstr* pcsString, const char* pcFormat, ...);
 void        csCat(cstr* pcsDest, const char* pcSource, const char* pcAdd);
 void        csAddChar(cstr* pcsDest, const char cAdd);
 void        csAddStr(cstr* pcsDest, const char* pcAdd);
+void        csReserve(cstr* pcsString, size_t sSize);
+void        csSetMem(cstr* pcsString, const char* pcMem, size_t sLen);
 long long   csInStr(long long llPosStart, const char* pcString, const char* pcFind);
 long long   csInStrRev(long long llPosStart, const char* pcString, const char* pcFind);
 void        csMid(cstr* pcsDest, const char* pcSource, long long llOffset, long long llLength);
@@ -495,6 +499,46 @@ void csAddStr(cstr* pcsDest, const char* pcAdd) {
   csCat(pcsDest, pcsDest->cStr, pcAdd);
 }
 
+/*******************************************************************************
+ * Name: csReserve
+ * Purpose: Grows cstr object's memory to at least sSize bytes, keeps string.
+ *******************************************************************************/
+void csReserve(cstr* pcsString, size_t sSize) {
+  // A freed cstr has no memory to double.
+  if (pcsString->cStr == NULL)
+    cstr_init(pcsString);
+
+  if ((long long) sSize > pcsString->size)
+    cstr_double_capacity_if_full(pcsString, (long long) sSize - pcsString->size);
+}
+
+/*******************************************************************************
+ * Name: csSetMem
+ * Purpose: Sets cstr object to sLen bytes of pcMem, which may contain '\0'.
+ *          Memory is only reallocated, if it's too small.
+ *******************************************************************************/
+void csSetMem(cstr* pcsString, const char* pcMem, size_t sLen) {
+  long long llOff = -1;
+
+  // Watch out, 'pcMem' could point into 'pcsString.cStr' and move with it!
+  if (pcsString->cStr != NULL && pcMem >= pcsString->cStr &&
+      pcMem < pcsString->cStr + pcsString->capacity)
+    llOff = pcMem - pcsString->cStr;
+
+  csReserve(pcsString, sLen + 1);
+  if (llOff >= 0) pcMem = pcsString->cStr + llOff;
+
+  memmove(pcsString->cStr, pcMem, sLen);
+  pcsString->cStr[sLen] = '\0';
+
+  // Adjust parameter. UTF-8 char is counted if it not continues.
+  pcsString->len     = sLen;
+  pcsString->size    = sLen + 1;
+  pcsString->lenUtf8 = 0;
+  for (size_t i = 0; i < sLen; ++i)
+    if (! cstr_utf8_cont(pcsString->cStr[i])) ++pcsString->lenUtf8;
+}
+
 /*******************************************************************************
  * Name: csInStr
  * Purpose: Finds first occurence's offset of pcFind in pcString from left.
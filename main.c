@@ -61,6 +61,54 @@
  ** 11.09.2025  JE    Now use csEq() family of functions.
  ** 16.09.2025  JE    Changed all occurrences of csCat(&str, str.cStr, "toadd") 
  **                   to csAddStr(&str, "toadd").
+ ** 19.10.2026  JE    Now use c_my_regex.h v0.13.1 with offsets only matchers.
+ ** 19.10.2026  JE    Now carve chunks with rxForEach() and carveEntry().
+ ** 19.10.2026  JE    Now set literal prefixes of all global regexes.
+ ** 19.10.2026  JE    Now stream files in 16 MiB chunks with 't_rx_stream',
+ **                   so no match is lost or reported twice at chunk borders.
+ **                   Removed 'readBytes2ByteArray()' and 'getNextDataChunk()'.
+ ** 19.10.2026  JE    Added option '--rxcache <dir>' for compiled regexes.
+ ** 19.10.2026  JE    Added option '--stats' printing regex profiling counters.
+ ** 19.10.2026  JE    Now all regexes have match, depth and heap limits. An entry
+ **                   hitting them is skipped and carving goes on.
+ ** 19.10.2026  JE    Added option '--grep <regex>' printing matching lines of
+ **                   files like 'grep -nb', instead of carving.
+ ** 19.10.2026  JE    Now '--grep' takes flag 'u' for UTF-8 text.
+ ** 19.10.2026  JE    Now regexes use named groups, which are resolved to
+ **                   numbers once in 'initGlobalRegexes()'.
+ ** 19.10.2026  JE    Now regular files are mapped and scanned in place with
+ **                   'openFileMapped()'. Others are still streamed in chunks.
+ ** 19.10.2026  JE    Removed the 'debug()' exit, 'debug()' now runs with '-t'
+ **                   only. Without it the given files are carved.
+ ** 19.10.2026  JE    Now built with 64 bit file offsets.
+ ** 19.10.2026  JE    Now streamed files are read ahead on a background thread.
+ ** 19.10.2026  JE    Now holes and all-zero blocks of mapped files are skipped.
+ **                   '--stats' prints the skipped bytes.
+ ** 19.10.2026  JE    Fixed: Label offset in 'getLable()' is a size_t, an int
+ **                   overflowed beyond 2 GiB.
+ ** 19.10.2026  JE    Added options '--chunk <size>', '--overlap <size>' and
+ **                   '--max-memory <size>'. Buffers are no bigger than a file.
+ ** 19.10.2026  JE    Added option '-j n' carving pieces of mapped files in n
+ **                   threads. Their output is written in order of the pieces.
+ ** 19.10.2026  JE    Now '--grep' is dispatched first, before '-t'.
+ ** 19.10.2026  JE    Added 'doParallelScan()' to 'debug()' comparing the hits
+ **                   of 'rxParallelScan()' and 'rxForEach()' at a range border.
+ ** 19.10.2026  JE    Now use c_string.h v0.25.0.
+ ** 19.10.2026  JE    Now 'getCoord()' takes a second pair by the named groups
+ **                   'lon2' and 'lat2', if the regex has them.
+ ** 19.10.2026  JE    Fixed: 'initEntry()' is called in 'main()' and in each
+ **                   carving thread, 'main()' calls 'freeEntry()', too.
+ ** 19.10.2026  JE    Fixed: Labels and coordinates are looked for in the
+ **                   overlap behind a match only, mapped or streamed alike.
+ ** 19.10.2026  JE    Fixed: 'printEntry()' and 'printProgress()' print offsets
+ **                   as size_t, an int overflowed beyond 2 GiB.
+ ** 19.10.2026  JE    Now only the label and coordinate regexes get a longer
+ **                   prefix, it made the record regex slower.
+ ** 19.10.2026  JE    Removed 'getLiteralPrefix()', '--grep' uses the regex's
+ **                   first code unit only. Lines lost to regex limits are
+ **                   counted and reported.
+ ** 19.10.2026  JE    'writePiece()' writes to 't_carve.hOut', 'debug()'
+ **                   compares '-j' output with a serial run.
  *******************************************************************************
  ** Skript tested with:
  ** TestDvice 123a.
@@ -70,6 +118,8 @@
 //******************************************************************************
 //* includes & namespaces
 
+#define _GNU_SOURCE             // For memrchr().
+#define _FILE_OFFSET_BITS 64    // For off_t and fseeko() beyond 2 GiB.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -85,7 +135,7 @@
 //******************************************************************************
 //* defines & macros
 
-#define ME_VERSION "0.0.54"
+#define ME_VERSION "0.0.80"
 cstr g_csMename;
 
 #define ERR_NOERR 0x00
@@ -101,9 +151,27 @@ cstr g_csMename;
 #define sERR_REGEX "Regex error"
 #define sERR_ELSE  "Unknown error"
 
+// initMatcher(): Limits against runaway backtracking on hostile data. Heap
+// limit is in KiB.
+#define RX_CARVE_MATCH_LIMIT 1000000
+#define RX_CARVE_DEPTH_LIMIT 100000
+#define RX_CARVE_HEAP_LIMIT  (64 * 1024)
+
 // getOptions(): Defines empty values.
 #define NO_TICK ((time_t) ~0)   // Fancy contruction to get a (-1). ;o)
 
+// getOptions(): Defaults and limits of chunks. Each match gets an overlap of
+// data after its end for labels and coordinates.
+#define CHUNK_SIZE   (16 * 1024 * 1024)
+#define CHUNK_MIN    (64 * 1024)
+#define OVERLAP_SIZE 1024
+
+// fitBuffers(): Chunks read ahead of the one being scanned.
+#define READ_AHEAD_BUFS 3
+
+// carvePiece(): Offset of a piece without any match.
+#define NO_OFF ((size_t) ~0)
+
 
 //******************************************************************************
 //* outsourced standard functions, includes and defines
@@ -133,16 +201,84 @@ typedef struct s_options {
   size_t sByteOff;
   int    iPrtOff;
   int    iPrtPrgrs;
+  int    iStats;    // Print regex stats to stderr.
+  int    iThreads;  // Carving threads of mapped files.
+  size_t sChunk;    // Bytes read or scanned at once.
+  size_t sOverlap;  // Bytes after a match's end, which must be in a chunk.
+  size_t sMaxMem;   // Budget of chunk buffers, 0 for none.
   int    iOptX;     // Integer verion.
   cstr   csOptX;    // String version.
   cstr   csRx;
   cstr   csRxF;
+  cstr   csRxCache; // Dir of compiled regex cache, empty for none.
+  cstr   csGrep;    // Regex of grep mode, empty for carving.
   time_t tTicksMin;
   time_t tTicksMax;
   cstr   csDateTime;
   time_t tDateTime;
 } t_options;
 
+// Grep mode state of a file. Lines are counted up to a global offset.
+typedef struct s_grep {
+  const char* pcFile;
+  int         fName;      // Print file's name in front of each line.
+  size_t      sLine;      // Number of line at sCounted.
+  size_t      sCounted;
+  size_t      sLimits;    // Regex limit hits, each may have lost a line.
+} t_grep;
+
+// Carving state handed to carveEntry() by rxStreamFeed() or to carveMapped()
+// by rxForEach(), which needs the mapped file and the scanned piece's offsets.
+typedef struct s_carve {
+  const char*  pcFile;
+  size_t       sFileSize;
+  const uchar* pucMap;
+  size_t       sBase;
+  size_t       sLimit;    // Matches start before, later ones are the next's.
+  size_t       sNext;     // Start of the next piece.
+  size_t       sLast;     // Offset of the last match.
+  size_t       sScanned;
+  FILE*        hOut;      // Entries are printed to.
+} t_carve;
+
+// Piece of a mapped file, which a worker of a t_pool carves into its own
+// output buffer.
+typedef struct s_piece {
+  size_t sStart;
+  size_t sStop;
+  size_t sFrom;     // Where the worker guessed the serial scan enters.
+  size_t sNext;     // Behind its last match, at least sStop.
+  size_t sLast;     // Offset of its last match or NO_OFF.
+  char*  pcOut;     // Of open_memstream().
+  size_t sOut;
+  int    iErr;
+  cstr   csErr;
+  int    fDone;
+} t_piece;
+
+// Worker pool carving pieces of a mapped file. The main thread queues pieces
+// in a ring and writes their output in the same order.
+typedef struct s_pool {
+  const t_file_map* ptMap;
+  t_carve           tC;         // File's state, copied by each thread.
+  t_rx_matcher*     prxLive;    // Main thread's matchers with the patterns.
+  t_rx_matcher*     prxLbl;
+  t_rx_matcher*     prxCoords;
+  pthread_t*        atThread;
+  int               iThreads;
+  t_piece*          atPiece;
+  int               iSlots;
+  size_t            sQueued;    // Counters of pieces, guarded by tLock.
+  size_t            sTaken;
+  size_t            sWritten;
+  size_t            sNext;      // Behind the last match written.
+  int               iErr;       // Of the first failed piece.
+  int               fStop;
+  pthread_mutex_t   tLock;
+  pthread_cond_t    tQueued;
+  pthread_cond_t    tDone;
+} t_pool;
+
 // Entry composition
 typedef struct s_entry {
   int     iType;
@@ -161,11 +297,23 @@ typedef struct s_entry {
 
 char* g_cType[8] = {0};
 
-t_rx_matcher g_rx_c2Lbl        = {0};
-t_rx_matcher g_rx_c2Coords     = {0};
-t_rx_matcher g_rx_c7TomTomLive = {0};
+// Matchers and entry are thread local, each carving thread has its own.
+__thread t_rx_matcher g_rx_c2Lbl        = {0};
+__thread t_rx_matcher g_rx_c2Coords     = {0};
+__thread t_rx_matcher g_rx_c7TomTomLive = {0};
 
-t_entry g_tE;
+// Group numbers of named groups, resolved once in initGlobalRegexes().
+int g_iGrpType     = 0;    // g_rx_c7TomTomLive
+int g_iGrpLon      = 0;
+int g_iGrpLat      = 0;
+int g_iGrpLen1     = 0;    // g_rx_c2Lbl
+int g_iGrpLen2     = 0;
+int g_iGrpLonRest  = 0;    // g_rx_c2Coords
+int g_iGrpLatRest  = 0;
+int g_iGrpLon2Rest = -1;   // Optional second pair, -1 if there is none.
+int g_iGrpLat2Rest = -1;
+
+__thread t_entry g_tE;
 
 // Arguments
 t_options     g_tOpts;  // CLI options and arguments.
@@ -188,18 +336,30 @@ void usage(int iErr, const char* pcMsg) {
 
   csSetf(&csMsg, "%s"
 //|************************ 80 chars width ****************************************|
-   "usage: %s [-t] [-b n] [-o] [-p] [-x n] [-X <str> [--rx <regex>] [--rxF <flags>]] [-e hex] [ox=hex] [-y yyyy [-Y yyyy]] file1 [file2 ...]\n"
+   "usage: %s [-t] [-b n] [-o] [-p] [-x n] [-X <str> [--rx <regex>] [--rxF <flags>]] [--rxcache <dir>] [--stats] [--grep <regex>] [--chunk size] [--overlap size] [--max-memory size] [-j n] [-e hex] [ox=hex] [-y yyyy [-Y yyyy]] file1 [file2 ...]\n"
    "       %s [-h|--help|-v|--version]\n"
    " What the programm should do.\n"
    " '-e' and 'ox=' can be entered as hexadecimal with '0x' prefix or as decimal\n"
    " with postfix K, M, G (meaning Kilo- Mega- and Giga-bytes based on 1024).\n"
-   "  -t:            don't execute printed commands (default execute)\n"
+   " So can the sizes of '--chunk', '--overlap' and '--max-memory'.\n"
+   "  -t:            print debug and test output instead of carving\n"
    "  -b n:          byte offset per file (default 0)\n"
    "  -o:            print additional offset column\n"
    "  -x n:          this is an option eating n\n"
    "  -X <str>:      this is an option eating a string\n"
    "  --rx <regex>:  gives an regex to match string provided by '-X'\n"
-   "  --rxF <flags>: flags with wich regex will be compiled (i.e. 'xims')\n"
+   "  --rxF <flags>: flags with wich regex will be compiled (i.e. 'ximsu')\n"
+   "  --rxcache <dir>:\n"
+   "                 load compiled regexes from dir or store them there\n"
+   "  --stats:       print calls, matches and time per regex to stderr\n"
+   "  --grep <regex>:\n"
+   "                 print lines matching regex (flags of '--rxF') like 'grep -nb'\n"
+   "  --chunk size:  bytes read or scanned at once (default 16M, at least 64K)\n"
+   "  --overlap size:\n"
+   "                 bytes after a match kept in its chunk for labels (default 1K)\n"
+   "  --max-memory size:\n"
+   "                 budget of chunk buffers, chunks shrink to fit (default none)\n"
+   "  -j n:          carve mapped files in n threads, 0 for all CPUs (default 1)\n"
    "  -e hex:        this is an hex/dec option eating a hex/dec string\n"
    "  ox=hex:        this is an hex/dec option eating a hex/dec string\n"
    "  -y yyyy:       min year to consider a track as valid (default 2002)\n"
@@ -285,10 +445,17 @@ void getOptions(int argc, char* argv[]) {
   g_tOpts.iTestMode  = 0;
   g_tOpts.sByteOff   = 0;
   g_tOpts.iPrtOff    = 0;
+  g_tOpts.iStats     = 0;
+  g_tOpts.iThreads   = 1;
+  g_tOpts.sChunk     = CHUNK_SIZE;
+  g_tOpts.sOverlap   = OVERLAP_SIZE;
+  g_tOpts.sMaxMem    = 0;
   g_tOpts.iOptX      = 0;
   g_tOpts.csOptX     = csNew("0f:aa:08:7e:50");
   g_tOpts.csRx       = csNew("([0-9a-fA-F]{2})(:?)");
   g_tOpts.csRxF      = csNew("");
+  g_tOpts.csRxCache  = csNew("");
+  g_tOpts.csGrep     = csNew("");
   g_tOpts.tTicksMin  = 2002;   // This will be converted into unix ticks.
   g_tOpts.tTicksMax  = NO_TICK;
   g_tOpts.csDateTime = csNew("");
@@ -330,6 +497,35 @@ next_argument:
           dispatchError(ERR_ARGS, "rxF is missing");
         continue;
       }
+      if (csEq(csArgv, "--stats")) {
+        g_tOpts.iStats = 1;
+        continue;
+      }
+      if (csEq(csArgv, "--grep")) {
+        if (! getArgStr(&g_tOpts.csGrep, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "grep regex is missing");
+        continue;
+      }
+      if (csEq(csArgv, "--chunk")) {
+        if (! getArgHexLong((ll*) &g_tOpts.sChunk, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No valid chunk size or missing");
+        continue;
+      }
+      if (csEq(csArgv, "--overlap")) {
+        if (! getArgHexLong((ll*) &g_tOpts.sOverlap, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No valid overlap or missing");
+        continue;
+      }
+      if (csEq(csArgv, "--max-memory")) {
+        if (! getArgHexLong((ll*) &g_tOpts.sMaxMem, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No valid memory budget or missing");
+        continue;
+      }
+      if (csEq(csArgv, "--rxcache")) {
+        if (! getArgStr(&g_tOpts.csRxCache, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "rxcache dir is missing");
+        continue;
+      }
       dispatchError(ERR_ARGS, "Invalid long option");
     }
 
@@ -374,6 +570,11 @@ next_argument:
             dispatchError(ERR_ARGS, "OptX is missing");
           continue;
         }
+        if (cOpt == 'j') {
+          if (! getArgInt(&g_tOpts.iThreads, &iArg, argc, argv, ARG_CLI, NULL))
+            dispatchError(ERR_ARGS, "No valid thread count or missing");
+          continue;
+        }
         if (cOpt == 'y') {
           if (! getArgTime(&g_tOpts.tTicksMin, &iArg, argc, argv, ARG_CLI, NULL))
             dispatchError(ERR_ARGS, "Min year is missing");
@@ -412,6 +613,25 @@ next_argument:
   if (g_tArgs.sCount == 0)
     dispatchError(ERR_ARGS, "No file");
 
+  // Sizes are read as signed, so a negative one is huge here.
+  if (g_tOpts.sChunk < CHUNK_MIN || (ll) g_tOpts.sChunk < 0)
+    dispatchError(ERR_ARGS, "Chunk size out of limits (at least 64K)");
+
+  if (g_tOpts.sOverlap == 0 || g_tOpts.sOverlap >= g_tOpts.sChunk)
+    dispatchError(ERR_ARGS, "Overlap out of limits (1 to chunk size)");
+
+  // At least two buffers are read into, while the stream holds a third.
+  if (g_tOpts.sMaxMem != 0 && ((ll) g_tOpts.sMaxMem < 0 ||
+      g_tOpts.sMaxMem < 3 * (size_t) CHUNK_MIN + g_tOpts.sOverlap))
+    dispatchError(ERR_ARGS, "Memory budget out of limits (at least 192K + overlap)");
+
+  if (g_tOpts.iThreads < 0)
+    dispatchError(ERR_ARGS, "Thread count out of limits (0 for all CPUs)");
+  if (g_tOpts.iThreads == 0)
+    g_tOpts.iThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (g_tOpts.iThreads < 1)
+    g_tOpts.iThreads = 1;
+
   if (g_tOpts.tTicksMin < 1970 || g_tOpts.tTicksMin > 2038)
     dispatchError(ERR_ARGS, "Min year out of limits (1970 - 2038)");
 
@@ -438,12 +658,34 @@ next_argument:
 
 /*******************************************************************************
  * Name:  initMatcher
- * Purpose: Initialize Matcher struct with regex string.
+ * Purpose: Initialize Matcher struct with regex string. Only offsets are used,
+ *          so no submatch strings are created. A literal prefix every match
+ *          starts with lets the matcher skip to candidates, sPrefixLen 0 keeps
+ *          the regex's first code unit. With '--rxcache'
+ *          the compiled regex is taken from there, if already stored. Limits
+ *          make a candidate fail fast instead of stalling the run.
  *******************************************************************************/
-void initMatcher(t_rx_matcher* pMatcher, const char* pcRegex) {
-  cstr csErr = csNew("");
-  if (rxInitMatcher(pMatcher, pcRegex, "", &csErr) != RX_NO_ERROR)
+void initMatcher(t_rx_matcher* pMatcher, const char* pcRegex, const char* pcPrefix, size_t sPrefixLen) {
+  cstr        csErr = csNew("");
+  const char* pcDir = (g_tOpts.csRxCache.len > 0) ? g_tOpts.csRxCache.cStr : NULL;
+
+  if (rxInitMatcherCached(pMatcher, pcRegex, "o", pcDir, &csErr) != RX_NO_ERROR)
     dispatchError(ERR_REGEX, csErr.cStr);
+  if (sPrefixLen > 0 && rxSetPrefix(pMatcher, pcPrefix, sPrefixLen, &csErr) != RX_NO_ERROR)
+    dispatchError(ERR_REGEX, csErr.cStr);
+  rxSetLimits(pMatcher, RX_CARVE_MATCH_LIMIT, RX_CARVE_DEPTH_LIMIT, RX_CARVE_HEAP_LIMIT);
+  csFree(&csErr);
+}
+
+/*******************************************************************************
+ * Name:  getGroup
+ * Purpose: Returns number of a named group, which must exist.
+ *******************************************************************************/
+int getGroup(t_rx_matcher* pMatcher, const char* pcName) {
+  int iGrp = rxGroupIndex(pMatcher, pcName);
+
+  if (iGrp < 0) dispatchError(ERR_REGEX, pcName);
+  return iGrp;
 }
 
 /*******************************************************************************
@@ -466,12 +708,14 @@ void initGlobalVars(void) {
  * Purpose: Assembles all global regexes.
  *******************************************************************************/
 void initGlobalRegexes(void) {
-  char* C               = "[\\x00-\\xff]";
-  cstr  cs_rx_cPrec     = csNew("");
-  cstr  cs_rx_cType     = csNew("");
-  cstr  cs_rx_c2Coords1 = csNew("");
-  cstr  cs_rx_c2Coords2 = csNew("");
-  cstr  cs_rx_temp      = csNew("");
+  char* C                = "[\\x00-\\xff]";
+  cstr  cs_rx_cPrec      = csNew("");
+  cstr  cs_rx_cType      = csNew("");
+  cstr  cs_rx_cTypeN     = csNew("");
+  cstr  cs_rx_c2Coords1  = csNew("");
+  cstr  cs_rx_c2Coords1N = csNew("");
+  cstr  cs_rx_c2Coords2  = csNew("");
+  cstr  cs_rx_temp       = csNew("");
 
   //  Main header fields:          Tag   Length  Tag Length  Value
   csSetf(&cs_rx_cPrec,     "(?x: \\x81\\x19  \\x03  \\x68  \\x01  (%s) )", C);
@@ -479,12 +723,24 @@ void initGlobalRegexes(void) {
   csSetf(&cs_rx_c2Coords1, "(?x: \\x83\\x19  \\x0a  \\x66  \\x08  (%s{4})(%s{4}) )", C, C);
   csSetf(&cs_rx_c2Coords2, "(?x: \\x84\\x19  \\x0a  \\x66  \\x08  (%s{4})(%s{4}) )", C, C);
 
-  // Rest of labels and coordinates.
-  csSetf(&cs_rx_temp, "(?x: \\x85\\x19 (%s) \\x64 (%s) )", C, C);
-  initMatcher(&g_rx_c2Lbl, cs_rx_temp.cStr);
-
-  csSetf(&cs_rx_temp, "(?x: \\xf6\\x1c \\x0a \\x66 \\x08 (%s{4})(%s{4}) )", C, C);
-  initMatcher(&g_rx_c2Coords, cs_rx_temp.cStr);
+  // Named once, the lookahead below repeats them unnamed.
+  csSetf(&cs_rx_cTypeN,     "(?x: \\x82\\x19  \\x03  \\x68  \\x01  (?<type>%s) )", C);
+  csSetf(&cs_rx_c2Coords1N, "(?x: \\x83\\x19  \\x0a  \\x66  \\x08  (?<lon>%s{4})(?<lat>%s{4}) )", C, C);
+
+  // Rest of labels and coordinates. A lookup finding nothing scans the whole
+  // overlap, the prefix makes that about twice as fast. A found one costs a
+  // bit more.
+  csSetf(&cs_rx_temp, "(?x: \\x85\\x19 (?<len1>%s) \\x64 (?<len2>%s) )", C, C);
+  initMatcher(&g_rx_c2Lbl, cs_rx_temp.cStr, "\x85\x19", 2);
+  g_iGrpLen1 = getGroup(&g_rx_c2Lbl, "len1");
+  g_iGrpLen2 = getGroup(&g_rx_c2Lbl, "len2");
+
+  csSetf(&cs_rx_temp, "(?x: \\xf6\\x1c \\x0a \\x66 \\x08 (?<lon>%s{4})(?<lat>%s{4}) )", C, C);
+  initMatcher(&g_rx_c2Coords, cs_rx_temp.cStr, "\xf6\x1c\x0a\x66\x08", 5);
+  g_iGrpLonRest  = getGroup(&g_rx_c2Coords, "lon");
+  g_iGrpLatRest  = getGroup(&g_rx_c2Coords, "lat");
+  g_iGrpLon2Rest = rxGroupIndex(&g_rx_c2Coords, "lon2");
+  g_iGrpLat2Rest = rxGroupIndex(&g_rx_c2Coords, "lat2");
 
   //  qr/
   //    rx_cPrec rx_cType.cStr rx_c2Coords_1.cStr rx_c2Coords_2.cStr
@@ -498,15 +754,28 @@ void initGlobalRegexes(void) {
                "(%s?)"
              "(?= (?: %s %s %s %s ) | \\Z | )"
            ")",
-           cs_rx_cPrec.cStr, cs_rx_cType.cStr, cs_rx_c2Coords1.cStr, cs_rx_c2Coords2.cStr,
+           cs_rx_cPrec.cStr, cs_rx_cTypeN.cStr, cs_rx_c2Coords1N.cStr, cs_rx_c2Coords2.cStr,
            C,
            cs_rx_cPrec.cStr, cs_rx_cType.cStr, cs_rx_c2Coords1.cStr, cs_rx_c2Coords2.cStr
         );
-  initMatcher(&g_rx_c7TomTomLive, cs_rx_temp.cStr);
+  // No longer prefix, most candidates are records, where an anchored call per
+  // candidate is slower than JIT's search for the first byte.
+  initMatcher(&g_rx_c7TomTomLive, cs_rx_temp.cStr, NULL, 0);
+  g_iGrpType = getGroup(&g_rx_c7TomTomLive, "type");
+  g_iGrpLon  = getGroup(&g_rx_c7TomTomLive, "lon");
+  g_iGrpLat  = getGroup(&g_rx_c7TomTomLive, "lat");
+
+  if (g_tOpts.iStats) {
+    rxEnableStats(&g_rx_c2Lbl, 1);
+    rxEnableStats(&g_rx_c2Coords, 1);
+    rxEnableStats(&g_rx_c7TomTomLive, 1);
+  }
 
   csFree(&cs_rx_cPrec);
   csFree(&cs_rx_cType);
+  csFree(&cs_rx_cTypeN);
   csFree(&cs_rx_c2Coords1);
+  csFree(&cs_rx_c2Coords1N);
   csFree(&cs_rx_c2Coords2);
   csFree(&cs_rx_temp);
 }
@@ -536,16 +805,16 @@ void printHeader(void) {
 //* Purpose: Cut labels from tlv: 85 19 l1 64 l2 "data".
 //*******************************************************************************
 void getLable(t_rx_matcher* rxMatcher, t_data* ptData, cstr* pcsLbl) {
-  cstr csLbl = csNew("");
-  int  iOff  = rxMatcher->dasEnd.pVal[2];
-  int  iLen1 = toInt((char*) &ptData->pBytes[rxMatcher->dasStart.pVal[1]], 1);
-  int  iLen2 = toInt((char*) &ptData->pBytes[rxMatcher->dasStart.pVal[2]], 1);
+  cstr   csLbl = csNew("");
+  size_t sOff  = rxMatcher->dasEnd.pVal[g_iGrpLen2];
+  int    iLen1 = toInt((char*) &ptData->pBytes[rxMatcher->dasStart.pVal[g_iGrpLen1]], 1);
+  int    iLen2 = toInt((char*) &ptData->pBytes[rxMatcher->dasStart.pVal[g_iGrpLen2]], 1);
 
-  // Error check.
-  if (iLen1 != iLen2 + 2) return;
+  // Error check, the label must be in the data, too.
+  if (iLen1 != iLen2 + 2 || sOff + iLen2 > ptData->sSize) return;
 
   // Create string with special printf format using a length and an offset.
-  csSetf(&csLbl, "%.*s", iLen2, &ptData->pBytes[iOff]);
+  csSetf(&csLbl, "%.*s", iLen2, &ptData->pBytes[sOff]);
 
   csSanitize(&csLbl);
 
@@ -617,14 +886,17 @@ int toWgs84(t_coord* ptcLon, t_coord* ptcLat) {
 
 //*******************************************************************************
 //* Name:  getCoord
-//* Purpose: Converts one or two coordinate pairs from bin to integer.
+//* Purpose: Converts one or two coordinate pairs from bin to integer. The
+//*          second pair needs groups 'lon2' and 'lat2', which the coordinate
+//*          regex hasn't got yet.
 //*******************************************************************************
 void getCoord(t_rx_matcher* rxM, t_data* ptD, ldbl* ldLo1, ldbl* ldLa1, ldbl* ldLo2, ldbl* ldLa2) {
-  *ldLo1 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[1]], 4);
-  *ldLa1 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[2]], 4);
+  *ldLo1 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[g_iGrpLonRest]], 4);
+  *ldLa1 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[g_iGrpLatRest]], 4);
   if (! (ldLo2 != NULL && ldLa2 != NULL)) return;
-  *ldLo2 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[3]], 4);
-  *ldLa2 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[4]], 4);
+  if (g_iGrpLon2Rest < 0 || g_iGrpLat2Rest < 0) return;
+  *ldLo2 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[g_iGrpLon2Rest]], 4);
+  *ldLa2 = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[g_iGrpLat2Rest]], 4);
 }
 
 //*******************************************************************************
@@ -640,8 +912,8 @@ void getCordWrapper(t_rx_matcher* rxM, t_data* ptD, size_t sOff, t_coord* tcLon1
   size_t sS    = ptD->sSize;
   ldbl*  pLon1 = &tcLon1->ldlVal;
   ldbl*  pLat1 = &tcLat1->ldlVal;
-  ldbl*  pLon2 = &tcLon2->ldlVal;
-  ldbl*  pLat2 = &tcLat2->ldlVal;
+  ldbl*  pLon2 = (tcLon2 != NULL) ? &tcLon2->ldlVal : NULL;
+  ldbl*  pLat2 = (tcLat2 != NULL) ? &tcLat2->ldlVal : NULL;
 
   // Get one or two pairs of coordinates from matches.
   if (rxMatch(rxM, sOff, pB, sS, &iErr, &csErr)) {
@@ -666,13 +938,14 @@ void getCoordinates(t_data* ptD, size_t sOff) {
  * Name:  getData
  * Purpose: Gets raw bytes and converts them to readable data.
  *******************************************************************************/
-int getData(t_rx_matcher* rxM, t_data* ptD) {
-  size_t sPos = rxM->dasStart.pVal[0];
+int getData(const PCRE2_SIZE* psOv, t_data* ptD) {
+  size_t sPos = psOv[O_START(0)];
+  size_t sEnd = psOv[O_END(0)];
 
   // Convert matched bytes.
-  g_tE.iType        = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[2]], 1);
-  g_tE.tcLon.ldlVal = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[3]], 4);
-  g_tE.tcLat.ldlVal = toInt((char*) &ptD->pBytes[rxM->dasStart.pVal[4]], 4);
+  g_tE.iType        = toInt((char*) &ptD->pBytes[psOv[O_START(g_iGrpType)]], 1);
+  g_tE.tcLon.ldlVal = toInt((char*) &ptD->pBytes[psOv[O_START(g_iGrpLon)]], 4);
+  g_tE.tcLat.ldlVal = toInt((char*) &ptD->pBytes[psOv[O_START(g_iGrpLat)]], 4);
 
   // Quick error check.
   if (g_tE.iType == 0) return 0;
@@ -680,7 +953,9 @@ int getData(t_rx_matcher* rxM, t_data* ptD) {
   // Convert and error check.
   if (! toWgs84(&g_tE.tcLon, &g_tE.tcLat)) return 0;
 
-  // Get rest of labels and coordinates.
+  // Get rest of labels and coordinates within the overlap behind the match,
+  // so a far away record isn't taken and mapped and streamed data agree.
+  if (ptD->sSize - sEnd > g_tOpts.sOverlap) ptD->sSize = sEnd + g_tOpts.sOverlap;
   getLables(ptD, sPos);
   getCoordinates(ptD, sPos);
 
@@ -691,10 +966,584 @@ int getData(t_rx_matcher* rxM, t_data* ptD) {
  * Name:  printEntry
  * Purpose: Prints generic csv file entry.
  *******************************************************************************/
-void printEntry(int iOffset) {
-  printf("<Remark>\t<Longitude>\t<Latitude>\t<Label>");
-  if (g_tOpts.iPrtOff) printf("\t%d", iOffset);
-  printf("\n");
+void printEntry(FILE* hOut, size_t sOffset) {
+  fprintf(hOut, "<Remark>\t<Longitude>\t<Latitude>\t<Label>");
+  if (g_tOpts.iPrtOff) fprintf(hOut, "\t%zu", sOffset);
+  fprintf(hOut, "\n");
+}
+
+/*******************************************************************************
+ * Name:  printProgress
+ * Purpose: Prints progress of search.
+ *******************************************************************************/
+void printProgress(const char* cFile, size_t sFileSize, size_t sOff) {
+  ldbl ldPercent = (ldbl) sOff / (ldbl) sFileSize * 100;
+  fprintf(stderr, "\rLast match in '%s' at %zu (%.2Lf %%) of %zu Bytes   ",
+          cFile, sOff, ldPercent, sFileSize);
+}
+
+/*******************************************************************************
+ * Name:  carveEntry
+ * Purpose: rxStreamFeed() callback, converts and prints one matched entry.
+ *******************************************************************************/
+int carveEntry(const t_rx_stream* prxStream, const PCRE2_SIZE* psOvector, int iCount, void* pvCarve) {
+  t_carve* ptC   = (t_carve*) pvCarve;
+  t_data   tData = {(uchar*) prxStream->pcBuf, prxStream->sLen};
+  size_t   sOff  = prxStream->sBase + psOvector[O_START(0)];   // Get global offset.
+
+  if (g_tOpts.iPrtPrgrs) printProgress(ptC->pcFile, ptC->sFileSize, sOff);
+
+  if (getData(psOvector, &tData)) printEntry(ptC->hOut, sOff);
+
+  return RX_RV_CONT;
+}
+
+/*******************************************************************************
+ * Name:  carveMapped
+ * Purpose: rxForEach() callback like carveEntry() for a piece of a mapped file.
+ *          getData() looks for labels and coordinates up to the overlap.
+ *          A match starting at the piece's limit ends it, the next piece
+ *          starts behind the last match instead.
+ *******************************************************************************/
+int carveMapped(const PCRE2_SIZE* psOvector, int iCount, void* pvCarve) {
+  t_carve* ptC   = (t_carve*) pvCarve;
+  t_data   tData = {(uchar*) ptC->pucMap + ptC->sBase, ptC->sFileSize - ptC->sBase};
+  size_t   sOff  = ptC->sBase + psOvector[O_START(0)];
+
+  if (sOff >= ptC->sLimit) return RX_RV_END;
+  if (ptC->sBase + psOvector[O_END(0)] > ptC->sNext)
+    ptC->sNext = ptC->sBase + psOvector[O_END(0)];
+  ptC->sLast = sOff;
+
+  // Workers leave the progress to the main thread.
+  if (g_tOpts.iPrtPrgrs && ptC->hOut == stdout) printProgress(ptC->pcFile, ptC->sFileSize, sOff);
+
+  if (getData(psOvector, &tData)) printEntry(ptC->hOut, sOff);
+
+  return RX_RV_CONT;
+}
+
+/*******************************************************************************
+ * Name:  fitBuffers
+ * Purpose: Sizes the chunks of a streamed file, which need not be bigger than
+ *          the file, if its size is known. Within '--max-memory' fewer chunks
+ *          are read ahead first, then they shrink. The stream keeps a chunk
+ *          and the overlap besides the read ahead buffers.
+ *******************************************************************************/
+void fitBuffers(size_t sFileSize, size_t* psChunk, int* piBufs) {
+  size_t sMax = 0;
+
+  *psChunk = g_tOpts.sChunk;
+  *piBufs  = READ_AHEAD_BUFS;
+
+  if (sFileSize > 0 && sFileSize < *psChunk) *psChunk = sFileSize;
+  if (g_tOpts.sMaxMem == 0) return;
+
+  sMax = g_tOpts.sMaxMem - g_tOpts.sOverlap;
+  while (*piBufs > 2 && (*piBufs + 1) * *psChunk > sMax) --*piBufs;
+  if ((*piBufs + 1) * *psChunk > sMax) *psChunk = sMax / (*piBufs + 1);
+}
+
+/*******************************************************************************
+ * Name:  carveMappedPiece
+ * Purpose: Scans a piece of data from sStart to sStop with '--overlap' bytes
+ *          more, so its last matches are complete. A match of the previous
+ *          piece may end behind sStart, ptC->sNext tells. It's set to where
+ *          the next piece starts, which is behind a match crossing sStop.
+ *******************************************************************************/
+int carveMappedPiece(const t_file_map* ptMap, t_carve* ptC, size_t sStart, size_t sStop, cstr* pcsErr) {
+  size_t sEnd = (ptMap->sSize - sStop > g_tOpts.sOverlap) ? sStop + g_tOpts.sOverlap : ptMap->sSize;
+
+  if (ptC->sNext > sStart) sStart = ptC->sNext;
+  if (sStart >= sStop) return RX_NO_ERROR;
+
+  ptC->sBase  = sStart;
+  ptC->sLimit = sStop;
+  ptC->sNext  = sStop;
+
+  return rxForEach(&g_rx_c7TomTomLive, (const char*) ptMap->pucData + sStart, sEnd - sStart, carveMapped, ptC, pcsErr);
+}
+
+/*******************************************************************************
+ * Name:  followMatch
+ * Purpose: rxForEach() callback like carveMapped(), which only follows the
+ *          matches up to the limit.
+ *******************************************************************************/
+int followMatch(const PCRE2_SIZE* psOvector, int iCount, void* pvCarve) {
+  t_carve* ptC = (t_carve*) pvCarve;
+
+  if (ptC->sBase + psOvector[O_START(0)] >= ptC->sLimit) return RX_RV_END;
+  if (ptC->sBase + psOvector[O_END(0)] > ptC->sNext)
+    ptC->sNext = ptC->sBase + psOvector[O_END(0)];
+
+  return RX_RV_CONT;
+}
+
+/*******************************************************************************
+ * Name:  pieceEntry
+ * Purpose: Guesses where a serial scan enters a piece at sStart. Matches
+ *          within '--overlap' bytes before are followed, the last one may end
+ *          behind sStart. writePiece() checks the guess.
+ *******************************************************************************/
+size_t pieceEntry(const t_file_map* ptMap, t_carve* ptC, size_t sStart) {
+  size_t sBack = (sStart > g_tOpts.sOverlap) ? sStart - g_tOpts.sOverlap : 0;
+  size_t sEnd  = (ptMap->sSize - sStart > g_tOpts.sOverlap) ? sStart + g_tOpts.sOverlap : ptMap->sSize;
+
+  ptC->sBase  = sBack;
+  ptC->sLimit = sStart;
+  ptC->sNext  = sStart;
+  rxForEach(&g_rx_c7TomTomLive, (const char*) ptMap->pucData + sBack, sEnd - sBack, followMatch, ptC, NULL);
+
+  return ptC->sNext;
+}
+
+/*******************************************************************************
+ * Name:  carvePiece
+ * Purpose: Carves a piece behind sFrom into its own output buffer.
+ *******************************************************************************/
+void carvePiece(const t_file_map* ptMap, t_carve* ptC, t_piece* ptPc, size_t sFrom) {
+  ptC->sNext  = sFrom;
+  ptC->sLast  = NO_OFF;
+  ptC->hOut   = open_memstream(&ptPc->pcOut, &ptPc->sOut);
+  ptPc->iErr  = carveMappedPiece(ptMap, ptC, ptPc->sStart, ptPc->sStop, &ptPc->csErr);
+  fclose(ptC->hOut);
+  ptPc->sNext = ptC->sNext;
+  ptPc->sLast = ptC->sLast;
+}
+
+/*******************************************************************************
+ * Name:  initThreadMatcher
+ * Purpose: Inits a thread's own matcher of a pattern, which the main thread's
+ *          matcher compiled.
+ *******************************************************************************/
+void initThreadMatcher(t_rx_matcher* pMatcher, const t_rx_matcher* pMain) {
+  rxInitMatcherShared(pMatcher, pMain->prxPattern);
+  rxSetLimits(pMatcher, RX_CARVE_MATCH_LIMIT, RX_CARVE_DEPTH_LIMIT, RX_CARVE_HEAP_LIMIT);
+  rxEnableStats(pMatcher, g_tOpts.iStats);
+}
+
+/*******************************************************************************
+ * Name:  carveWorker
+ * Purpose: Thread of a t_pool. Carves queued pieces with its own matchers and
+ *          entry until the pool stops. Then its counters are added to the
+ *          main thread's matchers, which waits in closePool() meanwhile.
+ *******************************************************************************/
+void* carveWorker(void* pvPool) {
+  t_pool*  ptP  = (t_pool*) pvPool;
+  t_carve  tC   = ptP->tC;
+  t_piece* ptPc = NULL;
+
+  initThreadMatcher(&g_rx_c7TomTomLive, ptP->prxLive);
+  initThreadMatcher(&g_rx_c2Lbl,        ptP->prxLbl);
+  initThreadMatcher(&g_rx_c2Coords,     ptP->prxCoords);
+  initEntry();
+
+  for (;;) {
+    pthread_mutex_lock(&ptP->tLock);
+    while (ptP->sTaken == ptP->sQueued && ! ptP->fStop)
+      pthread_cond_wait(&ptP->tQueued, &ptP->tLock);
+    if (ptP->sTaken == ptP->sQueued) {
+      pthread_mutex_unlock(&ptP->tLock);
+      break;
+    }
+    ptPc = &ptP->atPiece[ptP->sTaken++ % ptP->iSlots];
+    pthread_mutex_unlock(&ptP->tLock);
+
+    ptPc->sFrom = pieceEntry(ptP->ptMap, &tC, ptPc->sStart);
+    carvePiece(ptP->ptMap, &tC, ptPc, ptPc->sFrom);
+
+    pthread_mutex_lock(&ptP->tLock);
+    ptPc->fDone = 1;
+    pthread_cond_broadcast(&ptP->tDone);
+    pthread_mutex_unlock(&ptP->tLock);
+  }
+
+  pthread_mutex_lock(&ptP->tLock);
+  rxAddStats(ptP->prxLive,   &g_rx_c7TomTomLive);
+  rxAddStats(ptP->prxLbl,    &g_rx_c2Lbl);
+  rxAddStats(ptP->prxCoords, &g_rx_c2Coords);
+  pthread_mutex_unlock(&ptP->tLock);
+
+  rxFreeMatcher(&g_rx_c7TomTomLive);
+  rxFreeMatcher(&g_rx_c2Lbl);
+  rxFreeMatcher(&g_rx_c2Coords);
+  freeEntry();
+
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  openPool
+ * Purpose: Starts iThreads workers carving pieces of a mapped file. Two pieces
+ *          per thread may be queued.
+ *******************************************************************************/
+void openPool(t_pool* ptP, const t_file_map* ptMap, const t_carve* ptC, int iThreads) {
+  ptP->ptMap     = ptMap;
+  ptP->tC        = *ptC;
+  ptP->prxLive   = &g_rx_c7TomTomLive;
+  ptP->prxLbl    = &g_rx_c2Lbl;
+  ptP->prxCoords = &g_rx_c2Coords;
+  ptP->iThreads  = iThreads;
+  ptP->iSlots    = 2 * iThreads;
+  ptP->sQueued   = 0;
+  ptP->sTaken    = 0;
+  ptP->sWritten  = 0;
+  ptP->sNext     = 0;
+  ptP->iErr      = RX_NO_ERROR;
+  ptP->fStop     = 0;
+  ptP->atPiece   = (t_piece*) calloc(ptP->iSlots, sizeof(t_piece));
+  ptP->atThread  = (pthread_t*) malloc(sizeof(pthread_t) * iThreads);
+  for (int i = 0; i < ptP->iSlots; ++i)
+    ptP->atPiece[i].csErr = csNew("");
+
+  pthread_mutex_init(&ptP->tLock, NULL);
+  pthread_cond_init(&ptP->tQueued, NULL);
+  pthread_cond_init(&ptP->tDone, NULL);
+
+  for (int i = 0; i < iThreads; ++i)
+    pthread_create(&ptP->atThread[i], NULL, carveWorker, ptP);
+}
+
+/*******************************************************************************
+ * Name:  writePiece
+ * Purpose: Waits for the oldest piece and prints its output. If its worker
+ *          guessed the end of the previous piece's last match wrong, it is
+ *          carved again from there, so the output equals a serial run. After
+ *          an error the rest of the pieces is dropped.
+ *******************************************************************************/
+void writePiece(t_pool* ptP, cstr* pcsErr) {
+  t_piece* ptPc  = &ptP->atPiece[ptP->sWritten % ptP->iSlots];
+  t_carve  tC    = ptP->tC;
+  size_t   sFrom = 0;
+
+  pthread_mutex_lock(&ptP->tLock);
+  while (! ptPc->fDone)
+    pthread_cond_wait(&ptP->tDone, &ptP->tLock);
+  pthread_mutex_unlock(&ptP->tLock);
+
+  if (ptP->iErr == RX_NO_ERROR) {
+    sFrom = (ptP->sNext > ptPc->sStart) ? ptP->sNext : ptPc->sStart;
+    if (sFrom != ptPc->sFrom) {
+      free(ptPc->pcOut);
+      ptPc->sFrom = sFrom;
+      carvePiece(ptP->ptMap, &tC, ptPc, sFrom);
+    }
+    fwrite(ptPc->pcOut, 1, ptPc->sOut, ptP->tC.hOut);
+    if (g_tOpts.iPrtPrgrs && ptPc->sLast != NO_OFF)
+      printProgress(tC.pcFile, tC.sFileSize, ptPc->sLast);
+    ptP->sNext = ptPc->sNext;
+    if (ptPc->iErr != RX_NO_ERROR) {
+      ptP->iErr = ptPc->iErr;
+      csSet(pcsErr, ptPc->csErr.cStr);
+    }
+  }
+
+  free(ptPc->pcOut);
+  ptPc->pcOut = NULL;
+  ++ptP->sWritten;
+}
+
+/*******************************************************************************
+ * Name:  addPiece
+ * Purpose: Queues a piece for the workers. If all slots are taken, the oldest
+ *          piece is written first. Returns the error of a written piece.
+ *******************************************************************************/
+int addPiece(t_pool* ptP, size_t sStart, size_t sStop, cstr* pcsErr) {
+  t_piece* ptPc = NULL;
+
+  if (ptP->sQueued - ptP->sWritten == (size_t) ptP->iSlots)
+    writePiece(ptP, pcsErr);
+  if (ptP->iErr != RX_NO_ERROR)
+    return ptP->iErr;
+
+  ptPc         = &ptP->atPiece[ptP->sQueued % ptP->iSlots];
+  ptPc->sStart = sStart;
+  ptPc->sStop  = sStop;
+  ptPc->fDone  = 0;
+
+  pthread_mutex_lock(&ptP->tLock);
+  ++ptP->sQueued;
+  pthread_cond_signal(&ptP->tQueued);
+  pthread_mutex_unlock(&ptP->tLock);
+
+  return RX_NO_ERROR;
+}
+
+/*******************************************************************************
+ * Name:  pendingStart
+ * Purpose: Returns the start of the oldest piece not written yet, or sPos.
+ *******************************************************************************/
+size_t pendingStart(const t_pool* ptP, size_t sPos) {
+  if (ptP == NULL || ptP->sWritten == ptP->sQueued) return sPos;
+  return ptP->atPiece[ptP->sWritten % ptP->iSlots].sStart;
+}
+
+/*******************************************************************************
+ * Name:  closePool
+ * Purpose: Writes all pieces left, stops the workers and frees the pool.
+ *          Returns the error of the first failed piece.
+ *******************************************************************************/
+int closePool(t_pool* ptP, cstr* pcsErr) {
+  while (ptP->sWritten < ptP->sQueued)
+    writePiece(ptP, pcsErr);
+
+  pthread_mutex_lock(&ptP->tLock);
+  ptP->fStop = 1;
+  pthread_cond_broadcast(&ptP->tQueued);
+  pthread_mutex_unlock(&ptP->tLock);
+
+  for (int i = 0; i < ptP->iThreads; ++i)
+    pthread_join(ptP->atThread[i], NULL);
+
+  for (int i = 0; i < ptP->iSlots; ++i)
+    csFree(&ptP->atPiece[i].csErr);
+  free(ptP->atPiece);
+  free(ptP->atThread);
+  pthread_mutex_destroy(&ptP->tLock);
+  pthread_cond_destroy(&ptP->tQueued);
+  pthread_cond_destroy(&ptP->tDone);
+
+  return ptP->iErr;
+}
+
+/*******************************************************************************
+ * Name:  releaseBehind
+ * Purpose: With '--max-memory' releases the pages of a mapped file from
+ *          *psDone up to sPos, which are done with.
+ *******************************************************************************/
+void releaseBehind(const t_file_map* ptMap, size_t* psDone, size_t sPos) {
+  if (g_tOpts.sMaxMem == 0 || sPos <= *psDone) return;
+
+  releaseFileMapped(ptMap, *psDone, sPos - *psDone);
+  *psDone = sPos;
+}
+
+/*******************************************************************************
+ * Name:  carveMappedData
+ * Purpose: Scans runs of data of a mapped file only, skipping holes and
+ *          all-zero blocks. No match starts there, every one starts with a
+ *          non-zero prefix. Runs are scanned in pieces of '--chunk' bytes,
+ *          with '-j' by a pool of threads. With '--max-memory' the pages
+ *          behind pieces done are released, so a huge file doesn't pile up
+ *          in the resident set.
+ *******************************************************************************/
+int carveMappedData(const t_file_map* ptMap, t_carve* ptC, cstr* pcsErr) {
+  const uchar* puc    = ptMap->pucData;
+  size_t       sSize  = ptMap->sSize;
+  size_t       sPiece = g_tOpts.sChunk;
+  size_t       sMax   = 0;
+  size_t       sPos   = 0;
+  size_t       sRun   = 0;
+  size_t       sNext  = 0;   // Next block boundary.
+  size_t       sDone  = 0;   // Pages before are released.
+  off_t        oHole  = 0;
+  t_pool       tPool  = {0};
+  t_pool*      ptPool = NULL;
+  int          iErr   = RX_NO_ERROR;
+
+  if (g_tOpts.iThreads > 1) {
+    ptPool = &tPool;
+    openPool(ptPool, ptMap, ptC, g_tOpts.iThreads);
+  }
+
+  // The budget is shared by all pieces queued.
+  if (g_tOpts.sMaxMem > 0) {
+    sMax = g_tOpts.sMaxMem / (ptPool != NULL ? ptPool->iSlots : 1);
+    sMax = (sMax > g_tOpts.sOverlap + ZERO_BLOCK) ? sMax - g_tOpts.sOverlap : ZERO_BLOCK;
+    if (sPiece > sMax) sPiece = sMax;
+  }
+
+  ptC->sScanned = 0;
+  ptC->sNext    = 0;
+
+  while (sPos < sSize && iErr == RX_NO_ERROR) {
+    sPos = nextDataAt(ptMap->iFd, sPos, sSize, &oHole);
+
+    while (sPos < (size_t) oHole && iErr == RX_NO_ERROR) {
+      // Skip zero blocks, then take all blocks up to the next zero one.
+      for (;;) {
+        sNext = (sPos / ZERO_BLOCK + 1) * ZERO_BLOCK;
+        if (sNext > (size_t) oHole) sNext = oHole;
+        if (! isZeroBlock(puc + sPos, sNext - sPos)) break;
+        sPos = sNext;
+        if (sPos == (size_t) oHole) break;
+        if (sPos - sDone >= sPiece) releaseBehind(ptMap, &sDone, pendingStart(ptPool, sPos));
+      }
+      if (sPos == (size_t) oHole) break;
+
+      sRun = sPos;
+      for (sPos = sNext; sPos < (size_t) oHole && sPos - sRun < sPiece; sPos = sNext) {
+        sNext = (sPos / ZERO_BLOCK + 1) * ZERO_BLOCK;
+        if (sNext > (size_t) oHole) sNext = oHole;
+        if (isZeroBlock(puc + sPos, sNext - sPos)) break;
+      }
+
+      ptC->sScanned += sPos - sRun;
+      if (ptPool == NULL)
+        iErr = carveMappedPiece(ptMap, ptC, sRun, sPos, pcsErr);
+      else
+        iErr = addPiece(ptPool, sRun, sPos, pcsErr);
+      releaseBehind(ptMap, &sDone, pendingStart(ptPool, sPos));
+    }
+
+    if (sPos < (size_t) oHole) sPos = oHole;
+  }
+
+  if (ptPool != NULL)
+    iErr = closePool(ptPool, pcsErr);
+
+  return iErr;
+}
+
+/*******************************************************************************
+ * Name:  grepChunk
+ * Purpose: Prints all matching lines of a chunk, which holds only whole lines.
+ *          Line boundaries are searched only around a hit. Each line is
+ *          printed once, then search goes on with the next line.
+ *******************************************************************************/
+void grepChunk(t_rx_matcher* prxM, const char* pcBuf, size_t sLen, size_t sBase, t_grep* ptG) {
+  const char* pcNl   = NULL;
+  const char* pcFrom = NULL;
+  size_t      sPos   = 0;
+  size_t      sStart = 0;
+  size_t      sEnd   = 0;
+  size_t      sLs    = 0;   // Line's start.
+  size_t      sLe    = 0;   // Line's end, its '\n' or end of chunk.
+  int         iErr   = 0;
+
+  while (sPos < sLen) {
+    if (! rxMatch(prxM, sPos, pcBuf, sLen, &iErr, NULL)) {
+      if (iErr == RX_LIMIT) {
+        ++ptG->sLimits;
+        sPos = prxM->sPos;
+        continue;
+      }
+      break;
+    }
+    sStart = prxM->dasStart.pVal[0];
+    sEnd   = prxM->dasEnd.pVal[0];
+
+    pcNl = (sStart > 0) ? (const char*) memrchr(pcBuf, '\n', sStart) : NULL;
+    sLs  = (pcNl != NULL) ? (size_t) (pcNl - pcBuf) + 1 : 0;
+    pcNl = (const char*) memchr(pcBuf + sStart, '\n', sLen - sStart);
+    sLe  = (pcNl != NULL) ? (size_t) (pcNl - pcBuf) : sLen;
+
+    // A match over a line's end must match within the line, too. The chunk
+    // cut at the line's end keeps its validated UTF-8.
+    if (sEnd > sLe && ! rxMatch(prxM, sLs, pcBuf, sLe, &iErr, NULL)) {
+      if (iErr == RX_LIMIT) ++ptG->sLimits;
+      sPos = sLe + 1;
+      continue;
+    }
+
+    // Count lines from the last counted offset up to this line.
+    pcFrom = pcBuf + (ptG->sCounted - sBase);
+    while ((pcNl = (const char*) memchr(pcFrom, '\n', pcBuf + sLs - pcFrom)) != NULL) {
+      ++ptG->sLine;
+      pcFrom = pcNl + 1;
+    }
+    ptG->sCounted = sBase + sLs;
+
+    if (ptG->fName) printf("%s:", ptG->pcFile);
+    printf("%zu:%zu:", ptG->sLine, sBase + sLs);
+    fwrite(pcBuf + sLs, 1, sLe - sLs, stdout);
+    printf("\n");
+
+    sPos = sLe + 1;
+  }
+
+  // Rest of chunk's lines.
+  pcFrom = pcBuf + (ptG->sCounted - sBase);
+  while ((pcNl = (const char*) memchr(pcFrom, '\n', pcBuf + sLen - pcFrom)) != NULL) {
+    ++ptG->sLine;
+    pcFrom = pcNl + 1;
+  }
+  ptG->sCounted = sBase + sLen;
+}
+
+/*******************************************************************************
+ * Name:  grepFile
+ * Purpose: Greps a mapped file in one go. Else reads it in chunks cut after
+ *          their last '\n', so every chunk holds whole lines. The cut off rest
+ *          moves to the next chunk. A line longer than the buffer makes it
+ *          grow. Positions skipped by regex limits may have lost lines, their
+ *          count is reported.
+ *******************************************************************************/
+void grepFile(t_rx_matcher* prxM, const char* pcFile, int fName) {
+  t_file_map  tMap  = {0};
+  t_grep      tGrep = {pcFile, fName, 1, 0, 0};
+  size_t      sCap  = 16 * 1024 * 1024;
+  char*       pcBuf = NULL;
+  const char* pcNl  = NULL;
+  size_t      sHave = 0;    // Rest of last chunk at pcBuf.
+  size_t      sBase = 0;    // Global offset of pcBuf.
+  size_t      sRead = 0;
+  size_t      sUse  = 0;
+
+  if (openFileMapped(&tMap, pcFile)) {
+    grepChunk(prxM, (const char*) tMap.pucData, tMap.sSize, 0, &tGrep);
+    goto free_and_exit;
+  }
+
+  pcBuf = (char*) malloc(sCap);
+
+  for (;;) {
+    if (sHave == sCap) {
+      sCap  *= 2;
+      pcBuf  = (char*) realloc(pcBuf, sCap);
+    }
+    sRead = readBytesNext(pcBuf + sHave, sCap - sHave, tMap.hFile);
+
+    // Last line may have no '\n'.
+    if (sRead == 0) {
+      if (sHave > 0) grepChunk(prxM, pcBuf, sHave, sBase, &tGrep);
+      break;
+    }
+
+    sHave += sRead;
+    pcNl   = (const char*) memrchr(pcBuf, '\n', sHave);
+    if (pcNl == NULL) continue;
+
+    sUse = pcNl - pcBuf + 1;
+    grepChunk(prxM, pcBuf, sUse, sBase, &tGrep);
+
+    memmove(pcBuf, pcBuf + sUse, sHave - sUse);
+    sHave -= sUse;
+    sBase += sUse;
+  }
+
+free_and_exit:
+  if (tGrep.sLimits > 0 || g_tOpts.iStats)
+    fprintf(stderr, "Skipped %zu positions hitting regex limits in '%s'\n", tGrep.sLimits, pcFile);
+
+  free(pcBuf);
+  closeFileMapped(&tMap);
+}
+
+/*******************************************************************************
+ * Name:  grepFiles
+ * Purpose: Grep mode. '^' and '$' match at each line, like in grep.
+ *******************************************************************************/
+void grepFiles(void) {
+  t_rx_matcher rxMatcher = {0};
+  cstr         csErr     = csNew("");
+  cstr         csFlags   = csNew("");
+
+  csSetf(&csFlags, "%smo", g_tOpts.csRxF.cStr);
+  if (rxInitMatcher(&rxMatcher, g_tOpts.csGrep.cStr, csFlags.cStr, &csErr) != RX_NO_ERROR)
+    dispatchError(ERR_REGEX, csErr.cStr);
+
+  rxSetLimits(&rxMatcher, RX_CARVE_MATCH_LIMIT, RX_CARVE_DEPTH_LIMIT, RX_CARVE_HEAP_LIMIT);
+  if (g_tOpts.iStats) rxEnableStats(&rxMatcher, 1);
+
+  for (int i = 0; i < g_tArgs.sCount; ++i)
+    grepFile(&rxMatcher, g_tArgs.pVal[i].cStr, g_tArgs.sCount > 1);
+
+  if (g_tOpts.iStats) rxPrintStats(&rxMatcher, "Grep", stderr);
+
+  rxFreeMatcher(&rxMatcher);
+  csFree(&csErr);
+  csFree(&csFlags);
 }
 
 /*******************************************************************************
@@ -732,6 +1581,178 @@ free_and_exit:
   rxFreeMatcher(&rxMatcher);
 }
 
+/*******************************************************************************
+ * Name:  addHit
+ * Purpose: rxForEach() callback collecting hits like rxParallelScan().
+ *******************************************************************************/
+int addHit(const PCRE2_SIZE* psOvector, int iCount, void* pvHits) {
+  t_array(t_rx_hit)* pdaHits = (t_array(t_rx_hit)*) pvHits;
+  t_rx_hit           tHit    = {0};
+
+  tHit.sStart = psOvector[O_START(0)];
+  tHit.sEnd   = psOvector[O_END(0)];
+  daAdd(t_rx_hit, (*pdaHits), tHit);
+
+  return RX_RV_CONT;
+}
+
+/*******************************************************************************
+ * Name:  doParallelScan
+ * Purpose: Compares the hits of rxParallelScan() with rxForEach() on a buffer
+ *          of sLen dots, which has pcChars at the offsets in asOff.
+ *******************************************************************************/
+void doParallelScan(const char* pcRegex, const char* pcFlags, size_t sLen, const char* pcChars, const size_t* asOff, int iThreads, size_t sOverlap) {
+  t_rx_pattern      rxPattern = {0};
+  t_rx_matcher      rxMatcher = {0};
+  t_array(t_rx_hit) daSerial;
+  t_array(t_rx_hit) daPar;
+  cstr              csErr     = csNew("");
+  char*             pcBuf     = (char*) malloc(sLen);
+  int               fEqual    = 0;
+
+  daInit(t_rx_hit, daSerial);
+  daInit(t_rx_hit, daPar);
+
+  printf("\nParallel scan: '%s' flags '%s', %d threads, overlap %lu\n", pcRegex, pcFlags, iThreads, sOverlap);
+
+  memset(pcBuf, '.', sLen);
+  for (int i = 0; pcChars[i] != '\0'; ++i)
+    pcBuf[asOff[i]] = pcChars[i];
+
+  if (rxInitPattern(&rxPattern, pcRegex, pcFlags, &csErr) != RX_NO_ERROR) {
+    printf("%s\n", csErr.cStr);
+    goto free_and_exit;
+  }
+  rxInitMatcherShared(&rxMatcher, &rxPattern);
+
+  rxForEach(&rxMatcher, pcBuf, sLen, addHit, &daSerial, &csErr);
+  rxParallelScan(&rxPattern, pcBuf, sLen, iThreads, sOverlap, &daPar, &csErr);
+
+  fEqual = (daSerial.sCount == daPar.sCount);
+  for (size_t i = 0; fEqual && i < daSerial.sCount; ++i)
+    fEqual = daSerial.pVal[i].sStart == daPar.pVal[i].sStart && daSerial.pVal[i].sEnd == daPar.pVal[i].sEnd;
+
+  for (size_t i = 0; i < daPar.sCount; ++i)
+    printf("%lu-%lu\n", daPar.pVal[i].sStart, daPar.pVal[i].sEnd);
+  printf("Equal to rxForEach(): %s\n", fEqual ? "yes" : "NO");
+  printf("----\n");
+
+  rxFreeMatcher(&rxMatcher);
+  rxFreePattern(&rxPattern);
+
+free_and_exit:
+  daFree(daSerial);
+  daFree(daPar);
+  csFree(&csErr);
+  free(pcBuf);
+}
+
+/*******************************************************************************
+ * Name:  carveToString
+ * Purpose: Carves a file with '-j iThreads' into a malloc()ed string.
+ *******************************************************************************/
+char* carveToString(const char* pcFile, int iThreads, size_t* psLen) {
+  t_file_map tMap  = {0};
+  t_carve    tC    = {0};
+  cstr       csErr = csNew("");
+  char*      pcOut = NULL;
+
+  g_tOpts.iThreads = iThreads;
+  tC.pcFile        = pcFile;
+  tC.hOut          = open_memstream(&pcOut, psLen);
+
+  if (openFileMapped(&tMap, pcFile)) {
+    tC.pucMap    = tMap.pucData;
+    tC.sFileSize = tMap.sSize;
+    if (carveMappedData(&tMap, &tC, &csErr) != RX_NO_ERROR)
+      fprintf(tC.hOut, "%s\n", csErr.cStr);
+  }
+
+  fclose(tC.hOut);
+  closeFileMapped(&tMap);
+  csFree(&csErr);
+
+  return pcOut;
+}
+
+/*******************************************************************************
+ * Name:  doParallelCarve
+ * Purpose: Compares the output of '-j iThreads' with a serial run on a file of
+ *          sLen bytes noise, a zero block in each 64 KiB and records every 41
+ *          to 200 bytes. 27 bytes before each other block boundary a record
+ *          starts, a second one in its last coordinates, which a serial scan
+ *          skips. With an overlap shorter than that workers miss the first,
+ *          take the second and writePiece() must carve the piece again.
+ *******************************************************************************/
+void doParallelCarve(int iThreads, size_t sChunk, size_t sOverlap, size_t sLen) {
+  // Record with type 1 at 10.0, 20.0 and a second pair of coordinates.
+  const uchar aucRec[] = {0x81, 0x19, 0x03, 0x68, 0x01, 0x05,
+                          0x82, 0x19, 0x03, 0x68, 0x01, 0x01,
+                          0x83, 0x19, 0x0a, 0x66, 0x08, 0x40, 0x42, 0x0f, 0x00, 0x80, 0x84, 0x1e, 0x00,
+                          0x84, 0x19, 0x0a, 0x66, 0x08, 0x40, 0x42, 0x0f, 0x00, 0x80, 0x84, 0x1e, 0x00};
+  char     acFile[]  = "/tmp/carve_XXXXXX";
+  uchar*   pucBuf    = (uchar*) malloc(sLen);
+  char*    pcSerial  = NULL;
+  char*    pcPar     = NULL;
+  size_t   sSerial   = 0;
+  size_t   sPar      = 0;
+  size_t   sLines    = 0;
+  size_t   sChunkOld = g_tOpts.sChunk;
+  size_t   sOvlpOld  = g_tOpts.sOverlap;
+  int      iThrOld   = g_tOpts.iThreads;
+  int      iOffOld   = g_tOpts.iPrtOff;
+  uint32_t ui32Rnd   = 1;
+  int      iFd       = mkstemp(acFile);
+
+  printf("\nParallel carve: %zu bytes, pieces of %zu, overlap %zu, %d threads\n", sLen, sChunk, sOverlap, iThreads);
+
+  if (iFd < 0) {
+    printf("No temporary file\n");
+    free(pucBuf);
+    return;
+  }
+
+  for (size_t i = 0; i < sLen; ++i) {
+    ui32Rnd   = ui32Rnd * 1103515245 + 12345;
+    pucBuf[i] = (uchar) (ui32Rnd >> 16) | 0x01;
+  }
+  for (size_t i = 0x8000; i + ZERO_BLOCK <= sLen; i += 0x10000)
+    memset(pucBuf + i, 0, ZERO_BLOCK);
+  for (size_t i = 100; i + sizeof(aucRec) < sLen; i += 41 + (ui32Rnd >> 16) % 160) {
+    ui32Rnd = ui32Rnd * 1103515245 + 12345;
+    memcpy(pucBuf + i, aucRec, sizeof(aucRec));
+  }
+  for (size_t i = ZERO_BLOCK; i + sizeof(aucRec) + 3 < sLen; i += ZERO_BLOCK) {
+    if (i % 0x10000 == 0x8000 || i % 0x10000 == 0x9000) continue;
+    memcpy(pucBuf + i - 27, aucRec, sizeof(aucRec));
+    memcpy(pucBuf + i + 3,  aucRec, sizeof(aucRec));
+  }
+  if (write(iFd, pucBuf, sLen) != (ssize_t) sLen) printf("Short write\n");
+  close(iFd);
+
+  g_tOpts.sChunk   = sChunk;
+  g_tOpts.sOverlap = sOverlap;
+  g_tOpts.iPrtOff  = 1;
+  pcSerial = carveToString(acFile, 1,        &sSerial);
+  pcPar    = carveToString(acFile, iThreads, &sPar);
+
+  for (size_t i = 0; i < sSerial; ++i)
+    if (pcSerial[i] == '\n') ++sLines;
+
+  printf("Entries: %zu\n", sLines);
+  printf("Equal to serial run: %s\n", (sSerial == sPar && memcmp(pcSerial, pcPar, sSerial) == 0) ? "yes" : "NO");
+  printf("----\n");
+
+  g_tOpts.sChunk   = sChunkOld;
+  g_tOpts.sOverlap = sOvlpOld;
+  g_tOpts.iThreads = iThrOld;
+  g_tOpts.iPrtOff  = iOffOld;
+  unlink(acFile);
+  free(pucBuf);
+  free(pcSerial);
+  free(pcPar);
+}
+
 /*******************************************************************************
  * Name:  printCsInternals
  *******************************************************************************/
@@ -764,6 +1785,7 @@ void debug(void) {
   cstr csRx       = csNew("");
   cstr csTest     = csNew("abcd");
   cstr csDateTime = csNew("");
+  size_t asBorderOff[] = {65526, 65541, 65548};
 
   printCsInternals(&csTest);
 
@@ -818,6 +1840,15 @@ void debug(void) {
 
   doRegex(g_tOpts.csOptX.cStr, g_tOpts.csRx.cStr, g_tOpts.csRxF.cStr);
 
+  // A match across the first range border hides one, which only a serial
+  // scan behind it finds.
+  doParallelScan("a.{19}|b.{5}", "s", 200000, "aab", asBorderOff, 2, 64);
+
+  // Matches running into the next piece make workers guess where the serial
+  // scan enters it, the writer must fix wrong guesses.
+  doParallelCarve(3, 8192, OVERLAP_SIZE, 256 * 1024);
+  doParallelCarve(3, 8192, 24, 256 * 1024);
+
   csFree(&csMin);
   csFree(&csMax);
   csFree(&csSubRx);
@@ -826,61 +1857,22 @@ void debug(void) {
   csFree(&csDateTime);
 }
 
-/*******************************************************************************
- * Name:  readBytes2ByteArray
- * Purpose: Reads count bytes at offset into the dynamic byte array.
- *******************************************************************************/
-int readBytes2ByteArray(t_data* ptData, size_t sOff, size_t sCount, FILE* hFile) {
-  // Set file to offset befor reading from it!
-  fseek(hFile, sOff, SEEK_SET);
-
-  // Allocate memory only once.
-  if (ptData->pBytes == NULL) ptData->pBytes = (uchar*) malloc(sCount);
-
-  // Now read all
-  ptData->sSize = fread(ptData->pBytes, sizeof(char), sCount, hFile);
-
-  // No bytes is the end of file.
-  if (ptData->sSize == 0) {
-    free(ptData->pBytes);
-    return 0;
-  }
-
-  return 1;
-}
-
-/*******************************************************************************
- * Name:  getNextDataChunk
- * Purpose: Wrapper function for readBytes2ByteArray().
- *******************************************************************************/
-int getNextDataChunk(t_data* ptData, size_t sChunkSize, size_t sChunk, size_t sTwice, FILE* hFile) {
-  return readBytes2ByteArray(ptData, sChunk * sChunkSize, sChunkSize + sTwice, hFile);
-}
-
-/*******************************************************************************
- * Name:  printProgress
- * Purpose: Prints progress of search.
- *******************************************************************************/
-void printProgress(const char* cFile, size_t sFileSize, size_t sOff) {
-  ldbl ldPercent = (ldbl) sOff / (ldbl) sFileSize * 100;
-  fprintf(stderr, "\rLast match in '%s' at %li (%.2Lf %%) of %li Bytes   ",
-          cFile, sOff, ldPercent, sFileSize);
-}
-
 
 //******************************************************************************
 //* main
 
 int main(int argc, char *argv[]) {
-  FILE*  hFile     = NULL;
-  size_t sOff      = 0;
-  size_t sChunk    = 0;
-  size_t sFileSize = 0;
-
-  // 1 GiB chunks with 1 KiB overlap.
-  t_data tData      = {0};
-  size_t sChunkSize = 1024 * 1024 * 1024;
-  size_t sTwice     = 1024;
+  t_file_map tMap = {0};
+
+  // Regular files are mapped and scanned in place. Others are streamed
+  // through the matcher in chunks, while the next ones are read ahead.
+  t_rx_stream  tStream    = {0};
+  t_read_ahead tRa        = {0};
+  t_carve      tCarve     = {0};
+  const uchar* pucChunk   = NULL;
+  size_t       sRead      = 0;
+  size_t       sChunkSize = 0;
+  int          iReadAhead = 0;
 
   // Regex helper vars.
   cstr csErr = csNew("");
@@ -896,41 +1888,61 @@ int main(int argc, char *argv[]) {
   initGlobalVars();
   initGlobalRegexes();
   initTimeFunctions();
+  initEntry();
 
-  // Delete, when debugging is finished.
-  debug(); goto free_and_exit;
-  // Delete, when debugging is finished.
+  if (g_tOpts.csGrep.len > 0) {
+    grepFiles();
+    goto free_and_exit;
+  }
 
-  printHeader();
+  if (g_tOpts.iTestMode) {
+    debug();
+    goto free_and_exit;
+  }
 
-  // 'tData' will be initialized and destroyed in 'getNextDataChunk()'.
+  printHeader();
+  tCarve.hOut = stdout;
 
   // Get all data from all files.
   for (int i = 0; i < g_tArgs.sCount; ++i) {
-    hFile     = openFile(g_tArgs.pVal[i].cStr, "rb");
-    sFileSize = getFileSize(hFile);
+    tCarve.pcFile = g_tArgs.pVal[i].cStr;
+
 //-- file ----------------------------------------------------------------------
-    while (!feof(hFile)) {
-      sChunk       = 0;
-      tData.pBytes = NULL;
-      tData.sSize  = 0;
-      while (getNextDataChunk(&tData, sChunkSize, sChunk, sTwice, hFile)) {
-        g_rx_c7TomTomLive.sPos = 0; // Reset start of regex for each chunk.
-        while (rxMatch(&g_rx_c7TomTomLive, RX_KEEP_POS, (char*) tData.pBytes, tData.sSize, &iErr, &csErr)) {
-          // Get global offset.
-          sOff = sChunk * sChunkSize + g_rx_c7TomTomLive.dasStart.pVal[0];
-
-          if (g_tOpts.iPrtPrgrs) printProgress(g_tArgs.pVal[i].cStr, sFileSize, sOff);
-
-          if (! getData(&g_rx_c7TomTomLive, &tData)) continue;
-          printEntry(sOff);
-        }
-        ++sChunk;
-      }
+    if (openFileMapped(&tMap, tCarve.pcFile)) {
+      tCarve.pucMap    = tMap.pucData;
+      tCarve.sFileSize = tMap.sSize;
+      iErr = carveMappedData(&tMap, &tCarve, &csErr);
+      if (g_tOpts.iStats)
+        fprintf(stderr, "Skipped %zu of %zu bytes in holes and zero blocks of '%s'\n",
+                tMap.sSize - tCarve.sScanned, tMap.sSize, tCarve.pcFile);
+    }
+    else {
+      tCarve.pucMap    = NULL;
+      tCarve.sFileSize = getFileSize(tMap.hFile);
+      fitBuffers(tCarve.sFileSize, &sChunkSize, &iReadAhead);
+      rxInitStream(&tStream, &g_rx_c7TomTomLive, g_tOpts.sOverlap);
+      openReadAhead(&tRa, tMap.hFile, sChunkSize, iReadAhead);
+
+      // A chunk of 0 bytes is the final feed.
+      do {
+        pucChunk = readAheadNext(&tRa, &sRead);
+        iErr     = rxStreamFeed(&tStream, (const char*) pucChunk, sRead, sRead == 0, carveEntry, &tCarve, &csErr);
+      } while (sRead > 0 && iErr == RX_NO_ERROR);
+
+      closeReadAhead(&tRa);
+      rxFreeStream(&tStream);
     }
 //-- file ----------------------------------------------------------------------
-    if (g_tOpts.iPrtPrgrs) fprintf(stderr, "\n");
-    fclose(hFile);
+    if (iErr != RX_NO_ERROR)
+      fprintf(stderr, "\nSkipped rest of '%s': %s", tCarve.pcFile, csErr.cStr);
+    if (g_tOpts.iPrtPrgrs || iErr != RX_NO_ERROR) fprintf(stderr, "\n");
+    closeFileMapped(&tMap);
+  }
+
+  if (g_tOpts.iStats) {
+    rxPrintStats(&g_rx_c7TomTomLive, "TomTomLive", stderr);
+    rxPrintStats(&g_rx_c2Lbl,        "Label",      stderr);
+    rxPrintStats(&g_rx_c2Coords,     "Coords",     stderr);
   }
 
 free_and_exit:
@@ -940,8 +1952,11 @@ free_and_exit:
   csFree(&g_tOpts.csOptX);
   csFree(&g_tOpts.csRx);
   csFree(&g_tOpts.csRxF);
+  csFree(&g_tOpts.csRxCache);
+  csFree(&g_tOpts.csGrep);
   csFree(&g_tOpts.csDateTime);
   csFree(&g_csMename);
+  freeEntry();
   freeRxStructs();
 
   return ERR_NOERR;
@@ -2,7 +2,7 @@
  ** Name: stdfcns.c
  ** Purpose:  Keeps standard functions in one place for better maintenance.
  ** Author: (JE) Jens Elstner
- ** Version: v0.13.3
+ ** Version: v0.18.1
  *******************************************************************************
  ** Date        User  Log
  **-----------------------------------------------------------------------------
@@ -39,6 +39,23 @@
  ** 02.07.2026  JE    Removed 'revInt32()' and 'revInt64()'.
  ** 02.07.2026  JE    Refactored ticks2datetime().
  ** 15.07.2026  JE    Fixed bug in 'readBytesAt()' and 'writeBytesAt()'.
+ ** 19.10.2026  JE    Added 'openFileMapped()' and 'closeFileMapped()' mapping
+ **                   a whole file read-only or falling back to a FILE*.
+ ** 19.10.2026  JE    Changed 'long' offsets of 'readBytesAt()' and
+ **                   'writeBytesAt()' to 64 bit 'off_t' using 'fseeko()'.
+ ** 19.10.2026  JE    Added thread safe 'readBytesAtFd()', 'writeBytesAtFd()'
+ **                   and 'readVecAtFd()' using pread(), pwrite() and preadv().
+ ** 19.10.2026  JE    Added 'openReadAhead()', 'readAheadNext()' and
+ **                   'closeReadAhead()' reading chunks on a background thread.
+ ** 19.10.2026  JE    Now 'openFileMapped()' keeps the descriptor for
+ **                   'nextDataAt()', which skips holes of sparse files.
+ ** 19.10.2026  JE    Added 'isZeroBlock()'.
+ ** 19.10.2026  JE    Added 'releaseFileMapped()' to bound a mapping's resident
+ **                   pages.
+ ** 19.10.2026  JE    Fixed: 'getHexLongParm()' no longer frees the caller's
+ **                   string, when cutting off a postfix.
+ ** 19.10.2026  JE    Now the read-ahead thread reads seekable files with
+ **                   'readBytesAtFd()'. Renamed it to 'readAheadThread()'.
  *******************************************************************************/
 
 
@@ -51,6 +68,13 @@
 #include <stdint.h>       // For uint8_t, etc. typedefs.
 #include <sys/stat.h>     // for fstat to get file size.
 #include <ctype.h>        // for toupper().
+#include <fcntl.h>        // for open() in openFileMapped().
+#include <unistd.h>       // for close() and sysconf().
+#include <sys/mman.h>     // for mmap() and madvise().
+#include <sys/uio.h>      // for preadv().
+#include <limits.h>       // for IOV_MAX.
+#include <errno.h>        // for EINTR.
+#include <pthread.h>      // for the read ahead thread.
 
 // For IDE convenience.
 #include "c_string.h"
@@ -73,6 +97,12 @@
 #define ARG_VAL 0x00
 #define ARG_CLI 0x01
 
+// openFileMapped() aligns mappings of at least this size for huge pages.
+#define MAP_HUGE_ALIGN (2 * 1024 * 1024)
+
+// Block size of all-zero blocks, which can be skipped.
+#define ZERO_BLOCK 4096
+
 // Convenience macros
 #define arraySize(arr) (sizeof(arr) / sizeof(arr[0]))
 
@@ -104,6 +134,35 @@ typedef union u_char2Int64 {
   uint64_t uint64;
 } t_char2Int64;
 
+// openFileMapped() file. Either pucData maps it or hFile reads it in chunks.
+typedef struct s_file_map {
+  const uchar* pucData;
+  size_t       sSize;
+  int          iFd;       // Of the mapped file for nextDataAt().
+  FILE*        hFile;
+} t_file_map;
+
+// Ring of chunk buffers, filled by a thread and consumed by readAheadNext().
+typedef struct s_read_ahead {
+  FILE*           hFile;
+  int             iFd;
+  off_t           oPos;     // Next pread() offset, -1 reads hFile instead.
+  uchar**         apucBuf;
+  size_t*         asLen;
+  size_t          sChunk;
+  int             iBufs;
+  int             iHead;    // Next buffer to consume.
+  int             iTail;    // Next buffer to fill.
+  int             iUsed;    // Filled ones and the one held by the consumer.
+  int             fHeld;
+  int             fEof;
+  int             fStop;
+  pthread_mutex_t tLock;
+  pthread_cond_t  tFilled;
+  pthread_cond_t  tFreed;
+  pthread_t       tThread;
+} t_read_ahead;
+
 
 //******************************************************************************
 //* Functions
@@ -207,6 +266,7 @@ int isNumber(cstr sString, int* piSign) {
 ll getHexLongParm(cstr csParm, int* piErr) {
   cstr csPre  = csNew("");
   cstr csPost = csNew("");
+  cstr csNum  = csNew("");
   int  fHex   = 0;
   int  iPost  = 1;
   int  iSign  = 0;
@@ -241,16 +301,17 @@ ll getHexLongParm(cstr csParm, int* piErr) {
   else
     llVal = cstr2ll(csParm) * iPost;
 
-  // Remove postfix to use isNumber().
-  if (iPost > 1) csMid(&csParm, csParm.cStr, 0, csParm.len - 1);
+  // Remove postfix to use isNumber(). The copy is cut, csParm is the caller's.
+  csMid(&csNum, csParm.cStr, 0, (iPost > 1) ? csParm.len - 1 : csParm.len);
 
   // Error checks.
-  if (csParm.len == 0)                                  *piErr = 1;
-  if (fHex == 1 && iPost > 1)                           *piErr = 1;
-  if (fHex == 0 && isNumber(csParm, &iSign) != NUM_INT) *piErr = 1;
+  if (csNum.len == 0)                                  *piErr = 1;
+  if (fHex == 1 && iPost > 1)                          *piErr = 1;
+  if (fHex == 0 && isNumber(csNum, &iSign) != NUM_INT) *piErr = 1;
 
   csFree(&csPre);
   csFree(&csPost);
+  csFree(&csNum);
 
   return llVal;
 }
@@ -385,23 +446,231 @@ size_t getFileSize(FILE* hFile) {
   return sStat.st_size;
 }
 
+/*******************************************************************************
+ * Name:  openFileMapped
+ * Purpose: Maps a regular file read-only as a whole and returns 1. Pipes,
+ *          special and empty files, or a failing mmap() return 0 and an open
+ *          hFile to read in chunks instead. Throws an error, if file can't be
+ *          opened. The kernel is told to read ahead sequentially. A large
+ *          mapping starts at a huge page boundary, so it may use huge pages.
+ *******************************************************************************/
+int openFileMapped(t_file_map* ptMap, const char* pcName) {
+  struct stat sStat  = {0};
+  char*       pcArea = NULL;
+  char*       pcData = NULL;
+  size_t      sArea  = 0;
+  size_t      sPage  = (size_t) sysconf(_SC_PAGESIZE);
+  int         iFd    = open(pcName, O_RDONLY);
+
+  ptMap->pucData = NULL;
+  ptMap->sSize   = 0;
+  ptMap->iFd     = -1;
+  ptMap->hFile   = NULL;
+
+  if (iFd < 0 || fstat(iFd, &sStat) != 0 || ! S_ISREG(sStat.st_mode) || sStat.st_size == 0) {
+    if (iFd >= 0) close(iFd);
+    ptMap->hFile = openFile(pcName, "rb");
+    return 0;
+  }
+  ptMap->sSize = sStat.st_size;
+
+  // Reserve room to align the file's mapping, then cut off the rest.
+  if (ptMap->sSize >= MAP_HUGE_ALIGN) {
+    sArea  = ptMap->sSize + MAP_HUGE_ALIGN;
+    pcArea = (char*) mmap(NULL, sArea, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pcArea != MAP_FAILED) {
+      pcData = (char*) (((uintptr_t) pcArea + MAP_HUGE_ALIGN - 1) & ~(uintptr_t) (MAP_HUGE_ALIGN - 1));
+      if (mmap(pcData, ptMap->sSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, iFd, 0) == MAP_FAILED) {
+        munmap(pcArea, sArea);
+        pcData = NULL;
+      }
+      else {
+        size_t sMapped = (ptMap->sSize + sPage - 1) & ~(sPage - 1);
+        if (pcData > pcArea) munmap(pcArea, pcData - pcArea);
+        munmap(pcData + sMapped, pcArea + sArea - pcData - sMapped);
+      }
+    }
+  }
+
+  if (pcData == NULL) {
+    pcData = (char*) mmap(NULL, ptMap->sSize, PROT_READ, MAP_PRIVATE, iFd, 0);
+    if (pcData == MAP_FAILED) pcData = NULL;
+  }
+
+  if (pcData == NULL) {
+    close(iFd);
+    ptMap->sSize = 0;
+    ptMap->hFile = openFile(pcName, "rb");
+    return 0;
+  }
+
+  madvise(pcData, ptMap->sSize, MADV_SEQUENTIAL);
+  madvise(pcData, ptMap->sSize, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+  if (ptMap->sSize >= MAP_HUGE_ALIGN) madvise(pcData, ptMap->sSize, MADV_HUGEPAGE);
+#endif
+
+  ptMap->pucData = (const uchar*) pcData;
+  ptMap->iFd     = iFd;
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  closeFileMapped
+ *******************************************************************************/
+void closeFileMapped(t_file_map* ptMap) {
+  if (ptMap->pucData != NULL) munmap((void*) ptMap->pucData, ptMap->sSize);
+  if (ptMap->iFd     >= 0)    close(ptMap->iFd);
+  if (ptMap->hFile   != NULL) fclose(ptMap->hFile);
+  ptMap->pucData = NULL;
+  ptMap->sSize   = 0;
+  ptMap->iFd     = -1;
+  ptMap->hFile   = NULL;
+}
+
+/*******************************************************************************
+ * Name:  releaseFileMapped
+ * Purpose: Drops the pages of a mapping up to sOff + sLen from the resident
+ *          set, starting with the one sOff lies in. They are read again from
+ *          page cache or disk, if touched later.
+ *******************************************************************************/
+void releaseFileMapped(const t_file_map* ptMap, size_t sOff, size_t sLen) {
+  size_t sPage  = (size_t) sysconf(_SC_PAGESIZE);
+  size_t sStart = sOff & ~(sPage - 1);
+  size_t sStop  = (sOff + sLen) & ~(sPage - 1);
+
+  if (sStart < sStop)
+    madvise((void*) (ptMap->pucData + sStart), sStop - sStart, MADV_DONTNEED);
+}
+
+/*******************************************************************************
+ * Name:  nextDataAt
+ * Purpose: Returns the start of the next data at or after oOff and sets
+ *          *poHole to the hole behind it. Holes of a sparse file read as zeros
+ *          and aren't stored. Returns oEnd, if there is no data anymore.
+ *          Without SEEK_DATA support all the rest is data.
+ *******************************************************************************/
+off_t nextDataAt(int iFd, off_t oOff, off_t oEnd, off_t* poHole) {
+  off_t oData = lseek(iFd, oOff, SEEK_DATA);
+
+  *poHole = oEnd;
+  if (oData < 0) return (errno == ENXIO) ? oEnd : oOff;
+
+  *poHole = lseek(iFd, oData, SEEK_HOLE);
+  if (*poHole < 0 || *poHole > oEnd) *poHole = oEnd;
+
+  return oData;
+}
+
+/*******************************************************************************
+ * Name:  isZeroBlock
+ * Purpose: Returns 1, if all sLen bytes are zero. Ors 256 bytes at a time in
+ *          four lanes, which the compiler can vectorize, and stops at the first
+ *          non-zero ones.
+ *******************************************************************************/
+int isZeroBlock(const uchar* pucBlock, size_t sLen) {
+  uint64_t aui64[4] = {0};
+  uint64_t ui64     = 0;
+  size_t   i        = 0;
+
+  for (; i + 256 <= sLen; i += 256) {
+    for (size_t j = i; j < i + 256; j += sizeof(aui64)) {
+      memcpy(&ui64, pucBlock + j,      8); aui64[0] |= ui64;
+      memcpy(&ui64, pucBlock + j +  8, 8); aui64[1] |= ui64;
+      memcpy(&ui64, pucBlock + j + 16, 8); aui64[2] |= ui64;
+      memcpy(&ui64, pucBlock + j + 24, 8); aui64[3] |= ui64;
+    }
+    if (aui64[0] | aui64[1] | aui64[2] | aui64[3]) return 0;
+  }
+  for (; i < sLen; ++i)
+    aui64[0] |= pucBlock[i];
+
+  return aui64[0] == 0;
+}
+
 /*******************************************************************************
  * Name:  readBytesAt
  * Purpose: Reads sLen bytes from a file at given offset. Returns bytes read.
  *******************************************************************************/
-size_t readBytesAt(void* pData, long lOff, size_t sLen, FILE* hFile) {
-  if (fseek(hFile, lOff, SEEK_SET)) return 0;
+size_t readBytesAt(void* pData, off_t oOff, size_t sLen, FILE* hFile) {
+  if (fseeko(hFile, oOff, SEEK_SET)) return 0;
   return fread(pData, 1, sLen, hFile);
 }
 
 /*******************************************************************************
  * Name:  writeBytesAt
  *******************************************************************************/
-size_t writeBytesAt(void* pData, long lOff, size_t sLen, FILE* hFile) {
-  if (fseek(hFile, lOff, SEEK_SET)) return 0;
+size_t writeBytesAt(void* pData, off_t oOff, size_t sLen, FILE* hFile) {
+  if (fseeko(hFile, oOff, SEEK_SET)) return 0;
   return fwrite(pData, 1, sLen, hFile);
 }
 
+/*******************************************************************************
+ * Name:  readBytesAtFd
+ * Purpose: Reads sLen bytes from a file descriptor at given offset without
+ *          moving its file position, so threads can read the same file.
+ *          Returns bytes read, less only at EOF or on error.
+ *******************************************************************************/
+size_t readBytesAtFd(int iFd, void* pData, off_t oOff, size_t sLen) {
+  size_t  sDone = 0;
+  ssize_t ssRv  = 0;
+
+  while (sDone < sLen) {
+    ssRv = pread(iFd, (char*) pData + sDone, sLen - sDone, oOff + sDone);
+    if (ssRv < 0 && errno == EINTR) continue;
+    if (ssRv <= 0) break;
+    sDone += ssRv;
+  }
+  return sDone;
+}
+
+/*******************************************************************************
+ * Name:  writeBytesAtFd
+ * Purpose: Like readBytesAtFd() for writing. Returns bytes written.
+ *******************************************************************************/
+size_t writeBytesAtFd(int iFd, const void* pData, off_t oOff, size_t sLen) {
+  size_t  sDone = 0;
+  ssize_t ssRv  = 0;
+
+  while (sDone < sLen) {
+    ssRv = pwrite(iFd, (const char*) pData + sDone, sLen - sDone, oOff + sDone);
+    if (ssRv < 0 && errno == EINTR) continue;
+    if (ssRv <= 0) break;
+    sDone += ssRv;
+  }
+  return sDone;
+}
+
+/*******************************************************************************
+ * Name:  readVecAtFd
+ * Purpose: Scatters consecutive bytes from given offset into iCount buffers
+ *          with one preadv() call, if it isn't cut short. Else the rest is
+ *          read buffer by buffer. ptIov is left untouched. Returns bytes read.
+ *******************************************************************************/
+size_t readVecAtFd(int iFd, const struct iovec* ptIov, int iCount, off_t oOff) {
+  size_t  sDone = 0;
+  size_t  sPart = 0;
+  ssize_t ssRv  = 0;
+  int     i     = 0;
+
+  while (i < iCount) {
+    ssRv = preadv(iFd, ptIov + i, (iCount - i < IOV_MAX) ? iCount - i : IOV_MAX, oOff + sDone);
+    if (ssRv < 0 && errno == EINTR) continue;
+    if (ssRv <= 0) break;
+    sDone += ssRv;
+
+    // Skip full buffers, fill a partly read one.
+    while (i < iCount && (size_t) ssRv >= ptIov[i].iov_len) ssRv -= ptIov[i++].iov_len;
+    if (i < iCount && ssRv > 0) {
+      sPart  = readBytesAtFd(iFd, (char*) ptIov[i].iov_base + ssRv, oOff + sDone, ptIov[i].iov_len - ssRv);
+      sDone += sPart;
+      if (sPart < ptIov[i].iov_len - ssRv) break;
+      ++i;
+    }
+  }
+  return sDone;
+}
+
 /*******************************************************************************
  * Name:  readBytesNext
  * Purpose: Reads len bytes from a file. Returns bytes read.
@@ -410,6 +679,132 @@ size_t readBytesNext(void* pData, size_t len, FILE* hFile) {
   return fread(pData, 1, len, hFile);
 }
 
+/*******************************************************************************
+ * Name:  readAheadThread
+ * Purpose: Fills free buffers in order, until EOF or stop. Reading is done
+ *          unlocked, the consumer never touches a buffer not yet filled.
+ *******************************************************************************/
+static void* readAheadThread(void* pvRa) {
+  t_read_ahead* ptRa  = (t_read_ahead*) pvRa;
+  size_t        sRead = 0;
+  int           fStop = 0;
+
+  for (;;) {
+    pthread_mutex_lock(&ptRa->tLock);
+    while (ptRa->iUsed == ptRa->iBufs && ! ptRa->fStop)
+      pthread_cond_wait(&ptRa->tFreed, &ptRa->tLock);
+    fStop = ptRa->fStop;
+    pthread_mutex_unlock(&ptRa->tLock);
+    if (fStop) break;
+
+    if (ptRa->oPos >= 0) {
+      sRead       = readBytesAtFd(ptRa->iFd, ptRa->apucBuf[ptRa->iTail], ptRa->oPos, ptRa->sChunk);
+      ptRa->oPos += sRead;
+    }
+    else
+      sRead = readBytesNext(ptRa->apucBuf[ptRa->iTail], ptRa->sChunk, ptRa->hFile);
+
+    pthread_mutex_lock(&ptRa->tLock);
+    if (sRead > 0) {
+      ptRa->asLen[ptRa->iTail] = sRead;
+      ptRa->iTail = (ptRa->iTail + 1) % ptRa->iBufs;
+      ++ptRa->iUsed;
+    }
+    else {
+      ptRa->fEof = 1;
+    }
+    pthread_cond_signal(&ptRa->tFilled);
+    pthread_mutex_unlock(&ptRa->tLock);
+    if (sRead == 0) break;
+  }
+
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  openReadAhead
+ * Purpose: Starts reading hFile in chunks of sChunk bytes into iBufs buffers
+ *          on a background thread, so reading overlaps with processing.
+ *          The caller holds one buffer, so at least two are needed. Seekable
+ *          files are read with pread() from hFile's position, pipes with
+ *          fread().
+ *******************************************************************************/
+void openReadAhead(t_read_ahead* ptRa, FILE* hFile, size_t sChunk, int iBufs) {
+  if (iBufs < 2) iBufs = 2;
+
+  ptRa->hFile   = hFile;
+  ptRa->iFd     = fileno(hFile);
+  ptRa->oPos    = (ptRa->iFd >= 0) ? ftello(hFile) : -1;
+  ptRa->sChunk  = sChunk;
+  ptRa->iBufs   = iBufs;
+  ptRa->iHead   = 0;
+  ptRa->iTail   = 0;
+  ptRa->iUsed   = 0;
+  ptRa->fHeld   = 0;
+  ptRa->fEof    = 0;
+  ptRa->fStop   = 0;
+  ptRa->apucBuf = (uchar**) malloc(sizeof(uchar*) * iBufs);
+  ptRa->asLen   = (size_t*) calloc(iBufs, sizeof(size_t));
+  for (int i = 0; i < iBufs; ++i)
+    ptRa->apucBuf[i] = (uchar*) malloc(sChunk);
+
+  pthread_mutex_init(&ptRa->tLock, NULL);
+  pthread_cond_init(&ptRa->tFilled, NULL);
+  pthread_cond_init(&ptRa->tFreed, NULL);
+  pthread_create(&ptRa->tThread, NULL, readAheadThread, ptRa);
+}
+
+/*******************************************************************************
+ * Name:  readAheadNext
+ * Purpose: Hands back the buffer of the last call and returns the next chunk,
+ *          waiting for it, if needed. Returns NULL and *psLen = 0 at EOF.
+ *******************************************************************************/
+const uchar* readAheadNext(t_read_ahead* ptRa, size_t* psLen) {
+  const uchar* pucBuf = NULL;
+
+  pthread_mutex_lock(&ptRa->tLock);
+  if (ptRa->fHeld) {
+    ptRa->fHeld = 0;
+    --ptRa->iUsed;
+    pthread_cond_signal(&ptRa->tFreed);
+  }
+
+  while (ptRa->iUsed == 0 && ! ptRa->fEof)
+    pthread_cond_wait(&ptRa->tFilled, &ptRa->tLock);
+
+  *psLen = 0;
+  if (ptRa->iUsed > 0) {
+    pucBuf      = ptRa->apucBuf[ptRa->iHead];
+    *psLen      = ptRa->asLen[ptRa->iHead];
+    ptRa->iHead = (ptRa->iHead + 1) % ptRa->iBufs;
+    ptRa->fHeld = 1;
+  }
+  pthread_mutex_unlock(&ptRa->tLock);
+
+  return pucBuf;
+}
+
+/*******************************************************************************
+ * Name:  closeReadAhead
+ * Purpose: Stops the thread, also before EOF, and frees all buffers. The file
+ *          is left open.
+ *******************************************************************************/
+void closeReadAhead(t_read_ahead* ptRa) {
+  pthread_mutex_lock(&ptRa->tLock);
+  ptRa->fStop = 1;
+  pthread_cond_signal(&ptRa->tFreed);
+  pthread_mutex_unlock(&ptRa->tLock);
+  pthread_join(ptRa->tThread, NULL);
+
+  for (int i = 0; i < ptRa->iBufs; ++i)
+    free(ptRa->apucBuf[i]);
+  free(ptRa->apucBuf);
+  free(ptRa->asLen);
+  pthread_mutex_destroy(&ptRa->tLock);
+  pthread_cond_destroy(&ptRa->tFilled);
+  pthread_cond_destroy(&ptRa->tFreed);
+}
+
 /*******************************************************************************
  * Name:  readBytes
  * Purpose: Reads bytes from a file. 1 element = OK, 0 elements = EOF.